@@ -1,5 +1,10 @@
 #include "ActionAllowedHook.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string_view>
+
 #include "REL/Relocation.h"
 #include "RE/B/ButtonEvent.h"
 #include "RE/B/bhkCharacterController.h"
@@ -8,6 +13,7 @@
 #include "RE/P/PlayerCharacter.h"
 #include "RE/P/PlayerControls.h"
 #include "RE/P/PlayerControlsData.h"
+#include "RE/T/TESDataHandler.h"
 #include "RE/U/UserEvents.h"
 
 #include "SpellChargeTracker.h"
@@ -22,32 +28,112 @@ namespace ActionAllowedHook
 		using ActionAllowedFunc = bool (*)(RE::TESActionData*);
 		using SpellState = SpellChargeTracker::ActualState;
 
+		// Handlers receive the result of the original function and return the one passed on to the game
+		using RuleHandler = bool (*)(bool allowed);
+
+		struct ActionRule
+		{
+			std::string_view editorID;
+			RuleHandler handler;
+			const RE::BGSAction* action{ nullptr };
+		};
+
+		bool AllowWhileCasting(bool allowed)
+		{
+			if (allowed) {
+				return true;
+			}
+
+			auto* player = RE::PlayerCharacter::GetSingleton();
+			if (player
+				&& (((SpellState)player->magicCasters[RE::Actor::SlotTypes::kLeftHand]->state.get() != SpellState::kIdle) || ((SpellState)player->magicCasters[RE::Actor::SlotTypes::kRightHand]->state.get() != SpellState::kIdle))) {
+				// If the player is trying to do the action and one of the hands is currently charging/holding/casting a spell, allow it.
+				// Hopefully this doesn't allow jumps in unwanted situations.
+				return true;
+			}
+			return false;
+		}
+
+		bool RefreshAfterLanding(bool allowed)
+		{
+			if (allowed) {
+				// Force the input interceptor to reread the controller state so that spells are charged if hand was closed during jump
+				InputInterceptor::RefreshCastingState();
+			}
+			return allowed;
+		}
+
+		// Movement actions are added here, each one only costs a pointer compare per call
+		std::array g_rules{
+			ActionRule{ "ActionJump", AllowWhileCasting },
+			ActionRule{ "ActionLand", RefreshAfterLanding },
+		};
+
 		ActionAllowedFunc g_originalActionAllowed{ nullptr };
 		bool g_installed{ false };
 
-		bool ActionAllowedHook(RE::TESActionData* pActionData)
+		std::atomic<bool> g_countersEnabled{ false };
+		std::atomic<std::uint64_t> g_calls{ 0 };
+		std::atomic<std::uint64_t> g_totalNanoseconds{ 0 };
+
+		bool ApplyRules(RE::TESActionData* pActionData)
 		{
-			auto& actionID = pActionData->action->formEditorID;
 			bool result = g_originalActionAllowed(pActionData);
 
-			if (!result && actionID == "ActionJump") {
-				auto* player = RE::PlayerCharacter::GetSingleton();
-				if (player
-					&& (((SpellState)player->magicCasters[RE::Actor::SlotTypes::kLeftHand]->state.get() != SpellState::kIdle) || ((SpellState)player->magicCasters[RE::Actor::SlotTypes::kRightHand]->state.get() != SpellState::kIdle))) {
-					// If the player is trying to jump and one of the hands is currently charging/holding/casting a spell, allow the jump.
-					// Hopefully this doesn't allow jumps in unwanted situations.
-					result = true;
+			// Unresolved rules have no action and must not match an action data without one
+			const auto* action = pActionData->action;
+			for (const auto& rule : g_rules) {
+				if (rule.action && rule.action == action) {
+					result = rule.handler(result);
+					break;
 				}
-			} else if (result && actionID == "ActionLand") {
-				// Force the input interceptor to reread the controller state so that spells are charged if hand was closed during jump
-				InputInterceptor::RefreshCastingState();
 			}
 
-			//logger::info("{} -> {}", actionID.c_str(), result);
+			//logger::info("{} -> {}", action->formEditorID.c_str(), result);
+			return result;
+		}
+
+		bool ActionAllowedHook(RE::TESActionData* pActionData)
+		{
+			if (!g_countersEnabled.load(std::memory_order_relaxed)) {
+				return ApplyRules(pActionData);
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			const bool result = ApplyRules(pActionData);
+			const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+			g_calls.fetch_add(1, std::memory_order_relaxed);
+			g_totalNanoseconds.fetch_add(elapsed.count(), std::memory_order_relaxed);
 			return result;
 		}
 	}  // namespace
 
+	void ResolveActions()
+	{
+		auto* dataHandler = RE::TESDataHandler::GetSingleton();
+		if (!dataHandler) {
+			logger::error("ActionAllowedHook: data handler not available, actions not resolved");
+			return;
+		}
+
+		for (auto* action : dataHandler->GetFormArray<RE::BGSAction>()) {
+			if (!action) {
+				continue;
+			}
+			for (auto& rule : g_rules) {
+				if (!rule.action && action->formEditorID == rule.editorID) {
+					rule.action = action;
+				}
+			}
+		}
+
+		for (const auto& rule : g_rules) {
+			if (!rule.action) {
+				logger::warn("ActionAllowedHook: action {} not found, its rule is disabled", rule.editorID);
+			}
+		}
+	}
+
 	void Install()
 	{
 		if (g_installed) {
@@ -66,4 +152,14 @@ namespace ActionAllowedHook
 		g_installed = true;
 		logger::info("ActionAllowedHook: installed");
 	}
+
+	void SetCountersEnabled(bool enabled)
+	{
+		g_countersEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	Stats GetStats()
+	{
+		return { g_calls.load(std::memory_order_relaxed), g_totalNanoseconds.load(std::memory_order_relaxed) };
+	}
 }
@@ -1,6 +1,25 @@
 #pragma once
 
+#include <cstdint>
+
 namespace ActionAllowedHook
 {
+	struct Stats
+	{
+		std::uint64_t calls{ 0 };
+		std::uint64_t totalNanoseconds{ 0 };
+	};
+
+	/// <summary>
+	/// Resolves the BGSAction forms the hook reacts to. Must run once the data is loaded and before the hook is installed.
+	/// </summary>
+	void ResolveActions();
+
 	void Install();
+
+	// Per-call counting and timing, disabled by default like the event registry and animation router counters
+	void SetCountersEnabled(bool enabled);
+
+	// Call count and accumulated time spent in the hook, including the original function. Only counted while counters are enabled.
+	Stats GetStats();
 }
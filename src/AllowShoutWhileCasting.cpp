@@ -1,5 +1,11 @@
 #include <utils/BinaryPatcher.h>
+#include "CasterStateTracker.h"
+#include "InputInterceptor.h"
 #include "hooks/ActorMagicCaster.h"
+#include "utils/UITasks.h"
+
+#include <atomic>
+#include <chrono>
 
 namespace AllowShoutWhileCasting
 {
@@ -24,6 +30,30 @@ namespace AllowShoutWhileCasting
 		CheckCastFunc g_originalCheckCast{ nullptr };
 		bool g_installed{ false };
 
+		// Set while a task waits to resume the hand casts interrupted to let a shout through
+		std::atomic_bool g_resumePending{ false };
+
+		bool IsVoiceIdle()
+		{
+			const auto state = CasterStateTracker::lastVoiceState.load(std::memory_order_relaxed);
+			return state == CasterStateTracker::ActualState::kIdle || state == CasterStateTracker::ActualState::kUnknown;
+		}
+
+		Tasks::Task ResumeCastingAfterShout()
+		{
+			// The shout starts once the retried check went through. If it never does, the hands are resumed right away.
+			constexpr auto kShoutStartTimeout = std::chrono::milliseconds(500);
+			constexpr auto kShoutTimeout = std::chrono::seconds(10);
+			const bool shoutStarted = co_await Tasks::WaitUntil([] { return !IsVoiceIdle(); }, kShoutStartTimeout);
+			const bool shoutOver = !shoutStarted || co_await Tasks::WaitUntil(IsVoiceIdle, kShoutTimeout);
+			g_resumePending.store(false, std::memory_order_relaxed);
+
+			// Shout is over, resume the interrupted casts right away if the hands are still in casting position
+			if (shoutOver) {
+				InputInterceptor::RefreshCastingState();
+			}
+		}
+
 		bool CheckCastHook(RE::ActorMagicCaster* magicCaster, RE::MagicItem* spellOrShout, bool bDualCast, float* pfEffectiveStrength,
 			RE::MagicSystem::CannotCastReason* pCannotCastReason, bool bUseBaseValueForCost)
 		{
@@ -34,6 +64,9 @@ namespace AllowShoutWhileCasting
 				for (auto caster : { magicCaster->actor->GetMagicCaster(RE::MagicSystem::CastingSource::kLeftHand), magicCaster->actor->GetMagicCaster(RE::MagicSystem::CastingSource::kRightHand) }) {
 					caster->InterruptCast(true);
 				}
+				if (!g_resumePending.exchange(true, std::memory_order_relaxed)) {
+					Utils::UITasks::Spawn(ResumeCastingAfterShout());
+				}
 				result = g_originalCheckCast(magicCaster, spellOrShout, bDualCast, pfEffectiveStrength, pCannotCastReason, bUseBaseValueForCost);
 			}
 
@@ -52,6 +85,9 @@ namespace AllowShoutWhileCasting
 			return;
 		}
 
+		// The resume task follows the voice caster state
+		CasterStateTracker::Install();
+
 		g_installed = true;
 	}
 }
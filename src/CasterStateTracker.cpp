@@ -3,9 +3,17 @@
 #include "REL/Relocation.h"
 #include "SKSE/SKSE.h"
 #include "HandOrientation.h"
+#include "core/AllocAudit.h"
+#include "core/FlightRecorder.h"
+#include "core/Metrics.h"
 #include "hooks/ActorMagicCaster.h"
+#include "utils/FrameClock.h"
+#include "utils/UITasks.h"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -13,6 +21,7 @@ namespace CasterStateTracker
 {
 	std::atomic<ActualState> lastLeftHandState = ActualState::kUnknown;
 	std::atomic<ActualState> lastRightHandState = ActualState::kUnknown;
+	std::atomic<ActualState> lastVoiceState = ActualState::kUnknown;
 
 	namespace
 	{
@@ -20,25 +29,94 @@ namespace CasterStateTracker
 
 		std::atomic_bool g_installed{ false };
 		UpdateFunc g_originalUpdate{ nullptr };
+		HandTracker g_hands{ lastLeftHandState, lastRightHandState };
+
+		struct ListenerEntry
+		{
+			std::uint64_t id;
+			Listener listener;
+		};
+
+		struct ChargeListenerEntry
+		{
+			std::uint64_t id;
+			ChargeListener listener;
+			std::uint32_t steps;
+			std::array<std::int64_t, 2> lastStep{ -1, -1 };  // Last step sent per physical hand (left, right), only touched by the main thread
+		};
+
+		// Listener lists are copied on write. Dispatching is a single atomic load of the current list (a reference count bump, no
+		// g_listenerMutex and no copy), so the per-frame path doesn't allocate and listeners can add or remove listeners while
+		// being called. Writers are serialized by g_listenerMutex.
+		// The lists start out null, listeners are added from static initializers in other files.
+		template <class Entry>
+		using ListenerList = std::shared_ptr<const std::vector<Entry>>;
 
 		std::mutex g_listenerMutex;
-		std::vector<std::pair<std::uint64_t, Listener>> g_listeners;
+		std::atomic<ListenerList<ListenerEntry>> g_listeners;
+		std::atomic<ListenerList<std::shared_ptr<ChargeListenerEntry>>> g_chargeListeners;
 		std::atomic<std::uint64_t> g_nextListenerId{ 1 };
 
+		// Must be called with the lock held
+		template <class Entry>
+		std::shared_ptr<std::vector<Entry>> CopyForWrite(const std::atomic<ListenerList<Entry>>& list)
+		{
+			const auto current = list.load(std::memory_order_relaxed);
+			return current ? std::make_shared<std::vector<Entry>>(*current) : std::make_shared<std::vector<Entry>>();
+		}
+
 		void DispatchEvent(const StateChangedEvent& event)
 		{
-			std::vector<Listener> snapshot;
-			{
-				std::scoped_lock lock(g_listenerMutex);
-				for (const auto& [_, listener] : g_listeners) {
-					if (listener) {
-						snapshot.push_back(listener);
-					}
+			Metrics::Increment(Metrics::Counter::kCasterEvents);
+			for (const bool physicalLeft : { true, false }) {
+				if (event.AffectsHand(physicalLeft)) {
+					Recorder::ForHand(physicalLeft).Record(Recorder::RecordType::kCasterState, static_cast<std::uint8_t>(static_cast<int>(event.previousState) + 1), static_cast<std::uint8_t>(static_cast<int>(event.currentState) + 1), event.handMask);
+				}
+			}
+
+			const auto listeners = g_listeners.load(std::memory_order_acquire);
+			if (!listeners) {
+				return;
+			}
+
+			for (const auto& entry : *listeners) {
+				if (entry.listener) {
+					entry.listener(event);
 				}
 			}
+		}
+
+		float GetChargeProgress(const RE::ActorMagicCaster* caster)
+		{
+			return std::clamp(1.0f - (caster->castingTimer * 2.0f), 0.0f, 1.0f);
+		}
+
+		void DispatchChargeProgress(const HandOrientation::Info& orientation, RE::ActorMagicCaster* caster, bool charging)
+		{
+			const std::size_t hand = orientation.isPhysicalLeft ? 0 : 1;
+			const float progress = charging ? GetChargeProgress(caster) : 0.0f;
+
+			const auto listeners = g_chargeListeners.load(std::memory_order_acquire);
+			if (!listeners) {
+				return;
+			}
+
+			for (const auto& entry : *listeners) {
+				if (!charging) {
+					entry->lastStep[hand] = -1;
+					continue;
+				}
 
-			for (const auto& listener : snapshot) {
-				listener(event);
+				const auto step = ChargeStepFor(progress, entry->steps);
+				if (step != entry->lastStep[hand] && entry->listener) {
+					entry->lastStep[hand] = step;
+					entry->listener({
+						.orientation = orientation,
+						.castingSource = caster->castingSource,
+						.progress = static_cast<float>(step) / static_cast<float>(entry->steps),
+						.caster = caster,
+					});
+				}
 			}
 		}
 
@@ -53,38 +131,90 @@ namespace CasterStateTracker
 			}
 		}
 
-		void UpdateState(RE::ActorMagicCaster* caster)
+		void UpdateVoiceState(RE::ActorMagicCaster* caster)
 		{
-			auto* player = RE::PlayerCharacter::GetSingleton();
-			if (!player || caster->actor != player || !IsHandCaster(caster)) {
+			const ActualState newState = static_cast<ActualState>(caster->state.get());
+			const ActualState previousState = lastVoiceState.exchange(newState, std::memory_order_relaxed);
+			if (previousState == newState) {
+				return;
+			}
+
+			DispatchEvent({
+				.orientation = {},
+				.castingSource = caster->castingSource,
+				.previousState = previousState,
+				.currentState = newState,
+				.caster = caster,
+			});
+		}
+
+		void UpdateState(RE::PlayerCharacter* player, RE::ActorMagicCaster* caster)
+		{
+			if (caster->castingSource == RE::MagicSystem::CastingSource::kOther) {
+				UpdateVoiceState(caster);
+				return;
+			}
+
+			if (!IsHandCaster(caster)) {
 				return;
 			}
 
+			// When dual casting, the left-hand caster drives both hands so their timers can't diverge
+			const bool leftHandCaster = caster->castingSource == RE::MagicSystem::CastingSource::kLeftHand;
+			const bool dualCasting = player->IsDualCasting() && player->GetMagicCaster(RE::MagicSystem::CastingSource::kLeftHand);
 			const auto orientation = HandOrientation::FromCastingSource(caster->castingSource);
 
-			// When dual casting, use the left-hand caster state for both hands to avoid divergent timers.
-			auto* stateSource = caster;
-			if (player->IsDualCasting()) {
-				if (auto* leftCaster = player->GetMagicCaster(RE::MagicSystem::CastingSource::kLeftHand)) {
-					stateSource = reinterpret_cast<RE::ActorMagicCaster*>(leftCaster);
+			const ActualState newState = static_cast<ActualState>(caster->state.get());
+			const auto update = g_hands.OnCasterUpdate(leftHandCaster, orientation.isPhysicalLeft, newState, dualCasting);
+
+			for (const bool physicalLeft : { true, false }) {
+				if (update.chargeMask & HandMaskFor(physicalLeft)) {
+					DispatchChargeProgress(HandOrientation::FromPhysical(physicalLeft), caster, newState == ActualState::kCharging);
 				}
 			}
 
-			const ActualState newState = static_cast<ActualState>(stateSource->state.get());
-			auto& handState = orientation.isPhysicalLeft ? lastLeftHandState : lastRightHandState;
-			const ActualState previousState = handState.exchange(newState, std::memory_order_relaxed);
-
-			// Dispatch event if state changed or every frame while charging
-			if (previousState == newState && newState != ActualState::kCharging) {
+			if (update.changedMask == 0) {
 				return;
 			}
 
 			DispatchEvent({
 				.orientation = orientation,
 				.castingSource = caster->castingSource,
-				.previousState = previousState,
+				.previousState = update.previousState,
 				.currentState = newState,
-				.caster = stateSource,
+				.caster = caster,
+				.handMask = update.changedMask,
+			});
+		}
+
+		Utils::SeqLock<ISPVRApi::CasterStateSnapshot> g_snapshot;
+
+		ISPVRApi::CasterStateSnapshot::Hand DescribeHand(RE::PlayerCharacter* player, bool physicalLeft)
+		{
+			const auto state = (physicalLeft ? lastLeftHandState : lastRightHandState).load(std::memory_order_relaxed);
+			ISPVRApi::CasterStateSnapshot::Hand hand{ .state = static_cast<std::int32_t>(state) };
+
+			auto* caster = reinterpret_cast<RE::ActorMagicCaster*>(player->GetMagicCaster(HandOrientation::FromPhysical(physicalLeft).castingSource));
+			if (!caster) {
+				return hand;
+			}
+
+			if (state == ActualState::kCharging) {
+				hand.chargeProgress = GetChargeProgress(caster);
+			} else if (state == ActualState::kHolding) {
+				hand.chargeProgress = 1.0f;
+			}
+			hand.spellFormID = caster->currentSpell ? caster->currentSpell->GetFormID() : 0;
+			return hand;
+		}
+
+		// Rewrites the whole snapshot from both casters, so it is consistent no matter which caster updated last
+		void PublishSnapshot(RE::PlayerCharacter* player)
+		{
+			g_snapshot.Write({
+				.hands = { DescribeHand(player, true), DescribeHand(player, false) },
+				.dualCasting = player->IsDualCasting() ? 1u : 0u,
+				.frame = Utils::FrameClock::Get().FrameCount(),
 			});
 		}
 
@@ -92,25 +222,75 @@ namespace CasterStateTracker
 		{
 			g_originalUpdate(caster, delta);
 
-			UpdateState(caster);
+			// Every actor's casters run through here, NPCs return before anything is timed or recorded
+			auto* player = RE::PlayerCharacter::GetSingleton();
+			if (!player || caster->actor != player) {
+				return;
+			}
+
+			ISPVR_ALLOC_AUDIT_SCOPE("CasterStateTracker::UpdateHook");
+			const auto start = std::chrono::steady_clock::now();
+
+			// The player's left hand caster is updated once per frame, it doubles as the frame tick for UI tasks and frame aligned workers
+			if (caster->castingSource == RE::MagicSystem::CastingSource::kLeftHand) {
+				Utils::UITasks::OnFrame();
+				Utils::FrameClock::Get().Tick(start);
+			}
+
+			UpdateState(player, caster);
+			if (IsHandCaster(caster)) {
+				PublishSnapshot(player);
+			}
+			Metrics::Record(Metrics::Histogram::kCasterHookNanoseconds, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
 		}
 	}  // namespace
 
 	std::uint64_t AddListener(Listener listener)
 	{
 		const auto id = g_nextListenerId.fetch_add(1, std::memory_order_relaxed);
+
 		std::scoped_lock lock(g_listenerMutex);
-		g_listeners.emplace_back(id, std::move(listener));
+		auto listeners = CopyForWrite(g_listeners);
+		listeners->push_back({ .id = id, .listener = std::move(listener) });
+		g_listeners.store(std::move(listeners), std::memory_order_release);
 		return id;
 	}
 
 	void RemoveListener(std::uint64_t id)
 	{
 		std::scoped_lock lock(g_listenerMutex);
-		const auto it = std::remove_if(g_listeners.begin(), g_listeners.end(), [id](const auto& entry) {
-			return entry.first == id;
+		auto listeners = CopyForWrite(g_listeners);
+		std::erase_if(*listeners, [id](const auto& entry) {
+			return entry.id == id;
+		});
+		g_listeners.store(std::move(listeners), std::memory_order_release);
+	}
+
+	std::uint64_t AddChargeListener(ChargeListener listener, std::uint32_t steps)
+	{
+		const auto id = g_nextListenerId.fetch_add(1, std::memory_order_relaxed);
+		auto entry = std::make_shared<ChargeListenerEntry>(ChargeListenerEntry{ .id = id, .listener = std::move(listener), .steps = std::max(steps, 1u) });
+
+		std::scoped_lock lock(g_listenerMutex);
+		auto listeners = CopyForWrite(g_chargeListeners);
+		listeners->push_back(std::move(entry));
+		g_chargeListeners.store(std::move(listeners), std::memory_order_release);
+		return id;
+	}
+
+	void RemoveChargeListener(std::uint64_t id)
+	{
+		std::scoped_lock lock(g_listenerMutex);
+		auto listeners = CopyForWrite(g_chargeListeners);
+		std::erase_if(*listeners, [id](const auto& entry) {
+			return entry->id == id;
 		});
-		g_listeners.erase(it, g_listeners.end());
+		g_chargeListeners.store(std::move(listeners), std::memory_order_release);
+	}
+
+	const Utils::SeqLock<ISPVRApi::CasterStateSnapshot>& GetSnapshot()
+	{
+		return g_snapshot;
 	}
 
 	void Install()
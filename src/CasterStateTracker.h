@@ -5,26 +5,14 @@
 #include <atomic>
 #include <cstdint>
 #include <functional>
-#include <functional>
 #include "HandOrientation.h"
+#include "api/CasterStateInterface001.h"
+#include "core/CasterState.h"
+#include "core/HandTracker.h"
+#include "core/SeqLock.h"
 
 namespace CasterStateTracker
 {
-	enum class ActualState
-	{
-		kUnknown = -1,
-		kIdle = 0,
-		kStart,
-		kCharging,
-		kHolding,
-		kReleasing,
-		kChargingUnk,
-		kCasting,
-		kUnk07,
-		kUnk08,
-		kUnk09,
-	};
-
 	struct StateChangedEvent
 	{
 		HandOrientation::Info orientation;
@@ -32,15 +20,51 @@ namespace CasterStateTracker
 		ActualState previousState{ ActualState::kUnknown };
 		ActualState currentState{ ActualState::kUnknown };
 		RE::ActorMagicCaster* caster;
+
+		// While dual casting both hands share one state and a single event covers both of them. Empty for the voice caster.
+		std::uint8_t handMask{ 0 };
+
+		// Voice (shout/power) caster events carry no hand orientation.
+		[[nodiscard]] bool IsVoice() const { return castingSource == RE::MagicSystem::CastingSource::kOther; }
+		[[nodiscard]] bool AffectsHand(bool physicalLeft) const { return (handMask & HandMaskFor(physicalLeft)) != 0; }
+		[[nodiscard]] bool IsDualCast() const { return handMask == kBothHandsMask; }
+	};
+
+	struct ChargeProgressEvent
+	{
+		HandOrientation::Info orientation;
+		RE::MagicSystem::CastingSource castingSource;
+		float progress{ 0.0f };  // Charge progress (0-1), quantized to the granularity the listener subscribed with
+		RE::ActorMagicCaster* caster;
 	};
 
 	using Listener = std::function<void(const StateChangedEvent&)>;
+	using ChargeListener = std::function<void(const ChargeProgressEvent&)>;
 
 	extern std::atomic<ActualState> lastLeftHandState;
 	extern std::atomic<ActualState> lastRightHandState;
+	extern std::atomic<ActualState> lastVoiceState;
 
 	void Install();
 
+	/// <summary>
+	/// Subscribes to caster state changes. Only fires when the state actually changes, use AddChargeListener to follow the charge timer.
+	/// Listeners are called inside the caster update hook on the main thread and must return quickly. Slow work belongs on a
+	/// worker the listener posts to, like the spell haptics feed.
+	/// </summary>
 	std::uint64_t AddListener(Listener listener);
 	void RemoveListener(std::uint64_t id);
+
+	/// <summary>
+	/// Subscribes to charge progress while a hand is in kCharging. The progress is split into the given number of steps and the
+	/// listener is only called when a hand reaches a new step.
+	/// </summary>
+	std::uint64_t AddChargeListener(ChargeListener listener, std::uint32_t steps = 64);
+	void RemoveChargeListener(std::uint64_t id);
+
+	/// <summary>
+	/// State of the player's hand casters, rewritten on every update of one of them. Can be read from any thread without locking,
+	/// other plugins read it through the caster state API.
+	/// </summary>
+	const Utils::SeqLock<ISPVRApi::CasterStateSnapshot>& GetSnapshot();
 }
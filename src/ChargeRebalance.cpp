@@ -0,0 +1,98 @@
+#include "ChargeRebalance.h"
+
+#include "RE/Skyrim.h"
+#include "SKSE/SKSE.h"
+#include "ConfigManager.h"
+#include "Settings.h"
+#include "SpellMetadata.h"
+#include "core/ChargeRebalance.h"
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ChargeRebalance
+{
+	namespace
+	{
+		std::uint64_t g_configListenerId{ 0 };
+		std::atomic_bool g_applyQueued{ false };
+
+		// Original charge time of every spell changed by the last Apply, only touched on the main thread
+		std::vector<std::pair<RE::SpellItem*, float>> g_undo;
+
+		Spells::RemovedAnimationTimes ReadTimes()
+		{
+			const auto& config = Config::Manager::GetSingleton();
+			return {
+				.aimedCharge = static_cast<float>(config.Get<double>(Settings::kBalancingAimedChargeSeconds, 0.0)),
+				.selfCharge = static_cast<float>(config.Get<double>(Settings::kBalancingSelfChargeSeconds, 0.0)),
+				.release = static_cast<float>(config.Get<double>(Settings::kBalancingReleaseSeconds, 0.0)),
+			};
+		}
+
+		void RestoreOriginals()
+		{
+			if (g_undo.empty()) {
+				return;
+			}
+
+			for (const auto& [spell, chargeTime] : g_undo) {
+				spell->data.chargeTime = chargeTime;
+			}
+			logger::info("ChargeRebalance: restored the charge time of {} spells", g_undo.size());
+			g_undo.clear();
+		}
+
+		// Runs on the main thread, spell data is read by the game while casting
+		void Apply()
+		{
+			g_applyQueued.store(false, std::memory_order_relaxed);
+			RestoreOriginals();
+
+			// The table keeps the charge times the spells were loaded with, it doesn't have to be rebuilt for a new plan
+			const auto table = SpellMetadata::GetTable();
+			if (!table || !Config::Manager::GetSingleton().Get<bool>(Settings::kBalancingRebalanceChargeTimes, false)) {
+				return;
+			}
+
+			const auto plan = Spells::PlanChargeTimes(table->Entries(), ReadTimes());
+			g_undo.reserve(plan.size());
+			for (const auto& [formID, bonus] : plan) {
+				auto* spell = RE::TESForm::LookupByID<RE::SpellItem>(formID);
+				if (!spell) {
+					continue;
+				}
+				g_undo.emplace_back(spell, spell->data.chargeTime);
+				spell->data.chargeTime += bonus;
+			}
+			logger::info("ChargeRebalance: increased the charge time of {} spells", g_undo.size());
+		}
+
+		bool IsBalancingKey(std::string_view key)
+		{
+			return key == Settings::kBalancingRebalanceChargeTimes || key == Settings::kBalancingAimedChargeSeconds ||
+			       key == Settings::kBalancingSelfChargeSeconds || key == Settings::kBalancingReleaseSeconds;
+		}
+	}
+
+	void Undo()
+	{
+		RestoreOriginals();
+	}
+
+	void ConnectToConfig()
+	{
+		Apply();
+		if (g_configListenerId == 0) {
+			g_configListenerId = Config::Manager::GetSingleton().AddListener(
+				[](std::string_view key, [[maybe_unused]] const Config::Value& value, [[maybe_unused]] Config::ChangeSource source) {
+					// Settings change on the Papyrus or file threads. A batch touching several keys only queues one Apply.
+					if (IsBalancingKey(key) && !g_applyQueued.exchange(true, std::memory_order_relaxed)) {
+						SKSE::GetTaskInterface()->AddTask(Apply);
+					}
+				});
+		}
+	}
+}
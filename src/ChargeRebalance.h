@@ -0,0 +1,15 @@
+#pragma once
+
+namespace ChargeRebalance
+{
+	/// <summary>
+	/// Applies the charge time rebalancing according to the config and re-applies it whenever a balancing setting changes.
+	/// Must be called after the spell metadata table was built.
+	/// </summary>
+	void ConnectToConfig();
+
+	/// <summary>
+	/// Restores the charge times of all spells changed by the rebalancing. Must run on the main thread.
+	/// </summary>
+	void Undo();
+}
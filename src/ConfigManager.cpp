@@ -1,16 +1,13 @@
 #include "ConfigManager.h"
 
 #include <algorithm>
-#include <cctype>
-#include <iomanip>
-#include <locale>
 #include <map>
-#include <sstream>
 #include <vector>
 #include <string>
 
 #include "REL/Relocation.h"
 #include "SKSE/API.h"
+#include "core/Metrics.h"
 #include "utils/Input.h"
 #include <utils.h>
 #include <Settings.h>
@@ -20,33 +17,16 @@ namespace
 {
 	using namespace std::literals;
 
-	std::string_view TrimView(std::string_view input)
-	{
-		const auto first = input.find_first_not_of(" \t\r\n"sv);
-		if (first == std::string_view::npos) {
-			return {};
-		}
-		const auto last = input.find_last_not_of(" \t\r\n"sv);
-		return input.substr(first, last - first + 1);
-	}
-
-	std::string TrimCopy(std::string_view input)
-	{
-		const auto trimmed = TrimView(input);
-		return { trimmed.begin(), trimmed.end() };
-	}
+	constexpr auto kModEventName = "ImmersiveCastingVR_ConfigChanged"sv;
+	constexpr auto kBatchModEventName = "ImmersiveCastingVR_ConfigBatch"sv;
 
-	std::string ToLower(std::string_view input)
+	// Profile names end up in file names
+	bool IsValidProfileName(std::string_view name)
 	{
-		std::string result;
-		result.reserve(input.size());
-		for (const auto ch : input) {
-			result.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
-		}
-		return result;
+		return !name.empty() && name.size() <= 64 && std::ranges::all_of(name, [](char c) {
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+		});
 	}
-
-	constexpr auto kModEventName = "ImmersiveCastingVR_ConfigChanged"sv;
 }
 
 namespace Config
@@ -60,9 +40,9 @@ namespace Config
 
 	void Manager::RegisterSetting(std::string key, Type type, Value defaultValue, std::string description, std::string section)
 	{
-		if (ResolveValueType(defaultValue) != type) {
+		if (Codec::ResolveValueType(defaultValue) != type) {
 			logger::warn("Config setting '{}' default value type does not match the provided type; coercing", key);
-			if (auto coerced = DeserializeValue(type, SerializeValue(defaultValue, ResolveValueType(defaultValue)))) {
+			if (auto coerced = Codec::DeserializeValue(type, Codec::SerializeValue(defaultValue, Codec::ResolveValueType(defaultValue)))) {
 				defaultValue = *coerced;
 			} else {
 				logger::error("Failed to coerce default value for '{}'; using fallback", key);
@@ -123,14 +103,16 @@ namespace Config
 			}
 		}
 
-		std::vector<std::pair<std::string, Value>> changedSettings;
+		ChangeSet changedSettings;
+		std::uint64_t generation;
 		{
 			std::unique_lock lock(_mutex);
+			generation = _generation + 1;
 			for (auto& [key, setting] : _settings) {
 				Value newValue = setting.defaultValue;
 				const auto section = setting.section.empty() ? "" : setting.section.c_str();
 				if (const char* raw = ini.GetValue(section, key.c_str(), nullptr)) {
-					if (auto parsed = DeserializeValue(setting.type, raw)) {
+					if (auto parsed = Codec::DeserializeValue(setting.type, raw)) {
 						newValue = *parsed;
 					} else {
 						logger::warn("Config key '{}' has invalid value '{}'; falling back to default", key, raw);
@@ -139,21 +121,27 @@ namespace Config
 
 				if (!_loaded || setting.value != newValue) {
 					setting.value = newValue;
+					setting.changedGeneration = generation;
 					changedSettings.emplace_back(key, setting.value);
 				}
 			}
 			_loaded = true;
+			if (!changedSettings.empty()) {
+				_generation = generation;
+			}
 		}
 
-		for (const auto& [key, value] : changedSettings) {
-			DispatchChangeEvent(key, value, ChangeSource::kFromIni);
-		}
+		DispatchChanges(changedSettings, generation, ChangeSource::kFromIni);
 	}
 
 	void Manager::SaveToDisk()
 	{
 		EnsureIniPath();
+		WriteIniFile(_iniPath);
+	}
 
+	bool Manager::WriteIniFile(const std::filesystem::path& path) const
+	{
 		std::map<std::string, std::vector<std::pair<std::string, Setting>>> sections;
 		{
 			std::shared_lock lock(_mutex);
@@ -174,7 +162,7 @@ namespace Config
 		for (const auto& [section, settings] : sections) {
 			const auto* sectionName = section.c_str();
 			for (const auto& [key, setting] : settings) {
-				const auto value = SerializeValue(setting.value, setting.type);
+				const auto value = Codec::SerializeValue(setting.value, setting.type);
 				std::string comment_storage;
 				const char* comment = nullptr;
 				if (!setting.description.empty()) {
@@ -186,53 +174,51 @@ namespace Config
 		}
 
 		std::error_code ec;
-		std::filesystem::create_directories(_iniPath.parent_path(), ec);
+		std::filesystem::create_directories(path.parent_path(), ec);
 		if (ec) {
-			logger::error("Failed to create directories for '{}' ({})", _iniPath.string(), ec.message());
-			return;
-		}
-
-		if (const auto rc = ini.SaveFile(_iniPath.string().c_str()); rc < 0) {
-			logger::error("Failed to save config file '{}' (error {})", _iniPath.string(), rc);
-			return;
+			logger::error("Failed to create directories for '{}' ({})", path.string(), ec.message());
+			return false;
 		}
 
-		{
-			std::unique_lock lock(_mutex);
+		if (const auto rc = ini.SaveFile(path.string().c_str()); rc < 0) {
+			logger::error("Failed to save config file '{}' (error {})", path.string(), rc);
+			return false;
 		}
+		return true;
 	}
 
 	void Manager::ResetToDefaults()
 	{
-		std::vector<std::pair<std::string, Value>> changed;
-
+		ChangeSet changed;
+		std::uint64_t generation;
 		{
 			std::unique_lock lock(_mutex);
+			generation = _generation + 1;
 			for (auto& [key, setting] : _settings) {
 				if (setting.value != setting.defaultValue) {
 					setting.value = setting.defaultValue;
+					setting.changedGeneration = generation;
 					changed.emplace_back(key, setting.value);
 				}
 			}
+			if (!changed.empty()) {
+				_generation = generation;
+			}
 		}
 
-		for (const auto& [key, value] : changed) {
-			DispatchChangeEvent(key, value, ChangeSource::kFromCode);
-		}
+		DispatchChanges(changed, generation, ChangeSource::kFromCode);
 	}
 
 	bool Manager::HasKey(std::string_view key) const
 	{
-		const std::string keyStr(key);
 		std::shared_lock lock(_mutex);
-		return _settings.contains(keyStr);
+		return _settings.contains(key);
 	}
 
 	std::optional<Setting> Manager::GetSettingCopy(std::string_view key) const
 	{
-		const std::string keyStr(key);
 		std::shared_lock lock(_mutex);
-		if (const auto it = _settings.find(keyStr); it != _settings.end()) {
+		if (const auto it = _settings.find(key); it != _settings.end()) {
 			return it->second;
 		}
 		return std::nullopt;
@@ -240,8 +226,11 @@ namespace Config
 
 	Value Manager::GetValue(std::string_view key) const
 	{
-		if (auto setting = GetSettingCopy(key)) {
-			return setting->value;
+		{
+			std::shared_lock lock(_mutex);
+			if (const auto it = _settings.find(key); it != _settings.end()) {
+				return it->second.value;
+			}
 		}
 		logger::warn("Requested config key '{}' which is not registered", key);
 		return Value{ false };
@@ -249,41 +238,76 @@ namespace Config
 
 	void Manager::SetValue(std::string_view key, Value value, ChangeSource source, bool saveFile)
 	{
-		const std::string keyStr(key);
-
-		Value storedValue{};
+		std::vector<std::pair<std::string, Value>> values;
+		values.emplace_back(std::string(key), std::move(value));
+		SetValues(std::move(values), source, saveFile);
+	}
 
+	std::size_t Manager::SetValues(std::vector<std::pair<std::string, Value>> values, ChangeSource source, bool saveFile)
+	{
+		// Entries that did not change are removed, the rest is dispatched after the lock is released
+		std::uint64_t generation;
 		{
 			std::unique_lock lock(_mutex);
-			const auto it = _settings.find(keyStr);
-			if (it == _settings.end()) {
-				logger::warn("Attempted to set unregistered config key '{}'", key);
-				return;
-			}
+			generation = _generation + 1;
+			std::erase_if(values, [this, generation](auto& entry) {
+				auto& [key, value] = entry;
+				const auto it = _settings.find(key);
+				if (it == _settings.end()) {
+					logger::warn("Attempted to set unregistered config key '{}'", key);
+					return true;
+				}
 
-			const auto expectedType = it->second.type;
-			const auto incomingType = ResolveValueType(value);
-			if (incomingType != expectedType) {
-				if (auto coerced = DeserializeValue(expectedType, SerializeValue(value, incomingType))) {
-					value = *coerced;
-				} else {
-					logger::warn("Failed to coerce value for '{}' to expected type; ignoring update", key);
-					return;
+				const auto expectedType = it->second.type;
+				const auto incomingType = Codec::ResolveValueType(value);
+				if (incomingType != expectedType) {
+					if (auto coerced = Codec::DeserializeValue(expectedType, Codec::SerializeValue(value, incomingType))) {
+						value = *coerced;
+					} else {
+						logger::warn("Failed to coerce value for '{}' to expected type; ignoring update", key);
+						return true;
+					}
 				}
-			}
 
-			if (it->second.value == value) {
-				return;
+				if (it->second.value == value) {
+					return true;
+				}
+
+				it->second.value = value;
+				it->second.changedGeneration = generation;
+				return false;
+			});
+			if (!values.empty()) {
+				_generation = generation;
 			}
+		}
 
-			it->second.value = value;
-			storedValue = it->second.value;
+		if (values.empty()) {
+			return 0;
 		}
 
-		DispatchChangeEvent(keyStr, storedValue, source);
+		Metrics::Increment(Metrics::Counter::kConfigWrites, values.size());
+		DispatchChanges(values, generation, source);
 		if (saveFile) {
-			Manager::GetSingleton().SaveToDisk();
+			SaveToDisk();
 		}
+		return values.size();
+	}
+
+	std::vector<Manager::Entry> Manager::GetSectionValues(std::string_view section) const
+	{
+		std::vector<Entry> entries;
+		{
+			std::shared_lock lock(_mutex);
+			for (const auto& [key, setting] : _settings) {
+				if (section.empty() || setting.section == section) {
+					entries.push_back({ key, setting.type, setting.value });
+				}
+			}
+		}
+
+		std::ranges::sort(entries, {}, &Entry::key);
+		return entries;
 	}
 
 	std::uint64_t Manager::AddListener(Listener listener)
@@ -321,161 +345,214 @@ namespace Config
 
 	void Manager::DispatchFullSyncEvent(ChangeSource source)
 	{
-		std::vector<std::pair<std::string, Value>> snapshot;
+		// A full sync counts as a change of every setting, so lazy readers pick up all keys
+		ChangeSet snapshot;
+		std::uint64_t generation;
 		{
-			std::shared_lock lock(_mutex);
+			std::unique_lock lock(_mutex);
+			generation = ++_generation;
 			snapshot.reserve(_settings.size());
-			for (const auto& [key, setting] : _settings) {
+			for (auto& [key, setting] : _settings) {
+				setting.changedGeneration = generation;
 				snapshot.emplace_back(key, setting.value);
 			}
 		}
 
-		for (const auto& [key, value] : snapshot) {
-			DispatchChangeEvent(key, value, source);
-		}
+		DispatchChanges(snapshot, generation, source);
 	}
 
-	Config::Type Manager::ResolveValueType(const Value& value)
+	bool Manager::SwitchProfile(std::string_view name, ChangeSource source)
 	{
-		return std::visit(
-			[](auto&& val) -> Type {
-				using T = std::decay_t<decltype(val)>;
-				if constexpr (std::is_same_v<T, bool>) {
-					return Type::kBool;
-				} else if constexpr (std::is_same_v<T, std::int64_t>) {
-					return Type::kInteger;
-				} else if constexpr (std::is_same_v<T, double>) {
-					return Type::kFloat;
-				} else if constexpr (std::is_same_v<T, std::string>) {
-					return Type::kString;
-				} else {
-					static_assert(!sizeof(T), "Unsupported config value type");
-				}
-			},
-			value
-		);
+		const auto profile = LoadProfile(name);
+		if (!profile) {
+			logger::warn("Config profile '{}' does not exist or can't be read", name);
+			return false;
+		}
+
+		// SetValues drops values that are already active, listeners only see the settings that differ
+		const auto changed = SetValues(profile->values, source);
+		{
+			std::scoped_lock lock(_profileMutex);
+			_activeProfile = name;
+		}
+		logger::info("Switched to config profile '{}' ({} of {} settings changed)", name, changed, profile->values.size());
+		return true;
 	}
 
-	std::string Manager::SerializeValue(const Value& value, Type type)
+	bool Manager::SaveProfile(std::string_view name)
 	{
-		std::ostringstream stream;
-		stream.imbue(std::locale::classic());
-
-		switch (type) {
-		case Type::kBool:
-			stream << (std::get<bool>(value) ? "true" : "false");
-			break;
-		case Type::kInteger:
-			stream << std::get<std::int64_t>(value);
-			break;
-		case Type::kFloat:
-			stream << std::setprecision(6) << std::fixed << std::get<double>(value);
-			break;
-		case Type::kString:
-			{
-				const auto& str = std::get<std::string>(value);
-				if (str.find_first_of(" \t") != std::string::npos) {
-					stream << '"' << str << '"';
-				} else {
-					stream << str;
-				}
-				break;
-			}
+		if (!IsValidProfileName(name)) {
+			logger::warn("Invalid config profile name '{}'", name);
+			return false;
 		}
 
-		return stream.str();
+		if (!WriteIniFile(GetProfilePath(name))) {
+			return false;
+		}
+
+		std::scoped_lock lock(_profileMutex);
+		if (const auto it = _profiles.find(name); it != _profiles.end()) {
+			_profiles.erase(it);
+		}
+		_activeProfile = name;
+		return true;
 	}
 
-	std::optional<Value> Manager::DeserializeValue(Type type, std::string_view raw)
+	std::vector<std::string> Manager::GetProfiles() const
 	{
-		switch (type) {
-		case Type::kBool:
-			{
-				const auto lower = ToLower(raw);
-				if (lower == "true" || lower == "1" || lower == "yes" || lower == "on") {
-					return Value{ true };
-				}
-				if (lower == "false" || lower == "0" || lower == "no" || lower == "off") {
-					return Value{ false };
-				}
-				return std::nullopt;
+		EnsureIniPath();
+		const auto prefix = g_pluginNameShort + ".";
+
+		std::vector<std::string> profiles;
+		std::error_code ec;
+		for (const auto& file : std::filesystem::directory_iterator(_iniPath.parent_path(), ec)) {
+			const auto fileName = file.path().filename().string();
+			// The main file "<plugin>.ini" also starts with the prefix, a profile needs at least one character between the dots
+			if (!file.is_regular_file() || fileName.size() <= prefix.size() + 4 || !fileName.starts_with(prefix) || !fileName.ends_with(".ini")) {
+				continue;
 			}
-		case Type::kInteger:
-			{
-				try {
-					const auto value = std::stoll(std::string(raw));
-					return Value{ static_cast<std::int64_t>(value) };
-				} catch (...) {
-					return std::nullopt;
-				}
+
+			const auto name = std::string_view(fileName).substr(prefix.size(), fileName.size() - prefix.size() - 4);
+			if (IsValidProfileName(name)) {
+				profiles.emplace_back(name);
 			}
-		case Type::kFloat:
-			{
-				try {
-					const auto value = std::stod(std::string(raw));
-					return Value{ static_cast<double>(value) };
-				} catch (...) {
-					return std::nullopt;
-				}
+		}
+
+		std::ranges::sort(profiles);
+		return profiles;
+	}
+
+	std::string Manager::GetActiveProfile() const
+	{
+		std::scoped_lock lock(_profileMutex);
+		return _activeProfile;
+	}
+
+	std::filesystem::path Manager::GetProfilePath(std::string_view name) const
+	{
+		EnsureIniPath();
+		return _iniPath.parent_path() / std::format("{}.{}.ini", g_pluginNameShort, name);
+	}
+
+	std::shared_ptr<const Manager::Profile> Manager::LoadProfile(std::string_view name)
+	{
+		if (!IsValidProfileName(name)) {
+			return nullptr;
+		}
+
+		const auto path = GetProfilePath(name);
+		std::error_code ec;
+		const auto writeTime = std::filesystem::last_write_time(path, ec);
+		if (ec) {
+			return nullptr;
+		}
+
+		{
+			std::scoped_lock lock(_profileMutex);
+			if (const auto it = _profiles.find(name); it != _profiles.end() && it->second->writeTime == writeTime) {
+				return it->second;
 			}
-		case Type::kString:
-			{
-				auto str = TrimCopy(raw);
-				if (!str.empty() && str.front() == '"' && str.back() == '"' && str.size() >= 2) {
-					str = str.substr(1, str.size() - 2);
+		}
+
+		CSimpleIniA ini;
+		ini.SetUnicode();
+		if (const auto rc = ini.LoadFile(path.string().c_str()); rc < 0) {
+			logger::warn("Failed to load config profile '{}' (error {})", path.string(), rc);
+			return nullptr;
+		}
+
+		auto profile = std::make_shared<Profile>();
+		profile->writeTime = writeTime;
+		{
+			std::shared_lock lock(_mutex);
+			for (const auto& [key, setting] : _settings) {
+				const auto section = setting.section.empty() ? "" : setting.section.c_str();
+				const char* raw = ini.GetValue(section, key.c_str(), nullptr);
+				if (!raw) {
+					continue;
 				}
-				if (!str.empty()) {
-					return Value{ str };
+
+				if (auto parsed = Codec::DeserializeValue(setting.type, raw)) {
+					profile->values.emplace_back(key, std::move(*parsed));
+				} else {
+					logger::warn("Config profile '{}' has invalid value '{}' for '{}'; skipping it", name, raw, key);
 				}
-				return std::nullopt;
 			}
 		}
 
-		return std::nullopt;
+		std::scoped_lock lock(_profileMutex);
+		_profiles.insert_or_assign(std::string(name), profile);
+		return profile;
+	}
+
+	std::uint64_t Manager::GetGeneration() const
+	{
+		std::shared_lock lock(_mutex);
+		return _generation;
 	}
 
-	std::string_view Manager::TypeToString(Type type)
+	std::vector<std::string> Manager::GetChangedKeys(std::uint64_t sinceGeneration) const
 	{
-		switch (type) {
-		case Type::kBool:
-			return "bool"sv;
-		case Type::kInteger:
-			return "integer"sv;
-		case Type::kFloat:
-			return "float"sv;
-		case Type::kString:
-			return "string"sv;
-		default:
-			return "unknown"sv;
+		std::vector<std::string> keys;
+		{
+			std::shared_lock lock(_mutex);
+			for (const auto& [key, setting] : _settings) {
+				if (setting.changedGeneration > sinceGeneration) {
+					keys.push_back(key);
+				}
+			}
 		}
+
+		std::ranges::sort(keys);
+		return keys;
 	}
 
-	void Manager::DispatchChangeEvent(std::string_view key, const Value& value, ChangeSource source)
+	void Manager::DispatchChanges(const ChangeSet& changes, std::uint64_t generation, ChangeSource source)
 	{
+		if (changes.empty()) {
+			return;
+		}
+
 		std::vector<std::pair<std::uint64_t, Listener>> listenersSnapshot;
 		{
 			std::shared_lock lock(_mutex);
 			listenersSnapshot = _listeners;
 		}
 
-		for (const auto& [_, callback] : listenersSnapshot) {
-			if (callback) {
-				callback(key, value, source);
+		for (const auto& [key, value] : changes) {
+			for (const auto& [_, callback] : listenersSnapshot) {
+				if (callback) {
+					callback(key, value, source);
+				}
 			}
+			ISPVR_LOG_DEBUG("Config '{}' updated (type: {})", key, Codec::TypeToString(Codec::ResolveValueType(value)));
+		}
+
+		auto* eventSource = SKSE::GetModCallbackEventSource();
+		if (!eventSource) {
+			return;
 		}
 
-		if (auto* eventSource = SKSE::GetModCallbackEventSource()) {
-			static const RE::BSFixedString eventName(kModEventName.data());
-			std::string keyStr(key);
-			SKSE::ModCallbackEvent event;
-			event.eventName = eventName;
-			event.strArg = RE::BSFixedString(keyStr.c_str());
-			event.numArg = static_cast<float>(static_cast<std::int32_t>(source));
-			event.sender = nullptr;
-			eventSource->SendEvent(&event);
+		if (_perKeyEvents.load(std::memory_order_relaxed)) {
+			static const RE::BSFixedString keyEventName(kModEventName);
+			for (const auto& [key, _] : changes) {
+				SKSE::ModCallbackEvent event;
+				event.eventName = keyEventName;
+				event.strArg = RE::BSFixedString(key);
+				event.numArg = static_cast<float>(static_cast<std::int32_t>(source));
+				event.sender = nullptr;
+				eventSource->SendEvent(&event);
+			}
 		}
 
-		logger::debug("Config '{}' updated (type: {})", key, TypeToString(ResolveValueType(value)));
+		// One event per batch, listeners fetch the keys with GetChangedKeys. The generation is passed as a string, a float can't hold it exactly.
+		static const RE::BSFixedString batchEventName(kBatchModEventName);
+		SKSE::ModCallbackEvent event;
+		event.eventName = batchEventName;
+		event.strArg = RE::BSFixedString(std::to_string(generation));
+		event.numArg = static_cast<float>(static_cast<std::int32_t>(source));
+		event.sender = nullptr;
+		eventSource->SendEvent(&event);
 	}
 
 	void Manager::EnsureIniPath() const
@@ -537,6 +614,92 @@ namespace Config
 			Manager::GetSingleton().SetValue(key.c_str(), Value{ std::string(value.c_str()) }, ChangeSource::kFromMCM);
 		}
 
+		// Papyrus can't parse quoted strings, so unlike the ini strings are returned as they are
+		std::string ToPapyrusString(const Manager::Entry& entry)
+		{
+			if (const auto* str = std::get_if<std::string>(&entry.value)) {
+				return *str;
+			}
+			return Codec::SerializeValue(entry.value, entry.type);
+		}
+
+		std::vector<RE::BSFixedString> GetSectionKeys(RE::StaticFunctionTag*, RE::BSFixedString section)
+		{
+			std::vector<RE::BSFixedString> keys;
+			for (const auto& entry : Manager::GetSingleton().GetSectionValues(section.c_str())) {
+				keys.emplace_back(entry.key.c_str());
+			}
+			return keys;
+		}
+
+		std::vector<RE::BSFixedString> GetSectionValues(RE::StaticFunctionTag*, RE::BSFixedString section)
+		{
+			std::vector<RE::BSFixedString> values;
+			for (const auto& entry : Manager::GetSingleton().GetSectionValues(section.c_str())) {
+				values.emplace_back(ToPapyrusString(entry).c_str());
+			}
+			return values;
+		}
+
+		std::int32_t SetBulk(RE::StaticFunctionTag*, std::vector<RE::BSFixedString> keys, std::vector<RE::BSFixedString> values)
+		{
+			if (keys.size() != values.size()) {
+				logger::warn("SetBulk called with {} keys but {} values; ignoring", keys.size(), values.size());
+				return 0;
+			}
+
+			// Values arrive as strings and are coerced to the type of each setting
+			std::vector<std::pair<std::string, Value>> changes;
+			changes.reserve(keys.size());
+			for (std::size_t i = 0; i < keys.size(); ++i) {
+				changes.emplace_back(keys[i].c_str(), Value{ std::string(values[i].c_str()) });
+			}
+			return static_cast<std::int32_t>(Manager::GetSingleton().SetValues(std::move(changes), ChangeSource::kFromMCM));
+		}
+
+		std::int32_t GetGeneration(RE::StaticFunctionTag*)
+		{
+			return static_cast<std::int32_t>(Manager::GetSingleton().GetGeneration());
+		}
+
+		std::vector<RE::BSFixedString> GetChangedKeys(RE::StaticFunctionTag*, std::int32_t sinceGeneration)
+		{
+			std::vector<RE::BSFixedString> keys;
+			for (const auto& key : Manager::GetSingleton().GetChangedKeys(static_cast<std::uint64_t>(std::max(sinceGeneration, 0)))) {
+				keys.emplace_back(key.c_str());
+			}
+			return keys;
+		}
+
+		void SetPerKeyEvents(RE::StaticFunctionTag*, bool enabled)
+		{
+			Manager::GetSingleton().SetPerKeyEventsEnabled(enabled);
+		}
+
+		bool SwitchProfile(RE::StaticFunctionTag*, RE::BSFixedString name)
+		{
+			return Manager::GetSingleton().SwitchProfile(name.c_str(), ChangeSource::kFromMCM);
+		}
+
+		bool SaveProfile(RE::StaticFunctionTag*, RE::BSFixedString name)
+		{
+			return Manager::GetSingleton().SaveProfile(name.c_str());
+		}
+
+		std::vector<RE::BSFixedString> GetProfiles(RE::StaticFunctionTag*)
+		{
+			std::vector<RE::BSFixedString> profiles;
+			for (const auto& profile : Manager::GetSingleton().GetProfiles()) {
+				profiles.emplace_back(profile.c_str());
+			}
+			return profiles;
+		}
+
+		RE::BSFixedString GetActiveProfile(RE::StaticFunctionTag*)
+		{
+			return RE::BSFixedString(Manager::GetSingleton().GetActiveProfile().c_str());
+		}
+
 		void Reload(RE::StaticFunctionTag*)
 		{
 			Manager::GetSingleton().LoadFromDisk();
@@ -571,6 +734,16 @@ namespace Config
 		a_vm->RegisterFunction("SetInt", kScriptName.data(), SetInt);
 		a_vm->RegisterFunction("SetFloat", kScriptName.data(), SetFloat);
 		a_vm->RegisterFunction("SetString", kScriptName.data(), SetString);
+		a_vm->RegisterFunction("GetSectionKeys", kScriptName.data(), GetSectionKeys);
+		a_vm->RegisterFunction("GetSectionValues", kScriptName.data(), GetSectionValues);
+		a_vm->RegisterFunction("SetBulk", kScriptName.data(), SetBulk);
+		a_vm->RegisterFunction("GetGeneration", kScriptName.data(), GetGeneration);
+		a_vm->RegisterFunction("GetChangedKeys", kScriptName.data(), GetChangedKeys);
+		a_vm->RegisterFunction("SetPerKeyEvents", kScriptName.data(), SetPerKeyEvents);
+		a_vm->RegisterFunction("SwitchProfile", kScriptName.data(), SwitchProfile);
+		a_vm->RegisterFunction("SaveProfile", kScriptName.data(), SaveProfile);
+		a_vm->RegisterFunction("GetProfiles", kScriptName.data(), GetProfiles);
+		a_vm->RegisterFunction("GetActiveProfile", kScriptName.data(), GetActiveProfile);
 		a_vm->RegisterFunction("Reload", kScriptName.data(), Reload);
 		a_vm->RegisterFunction("Save", kScriptName.data(), Save);
 		a_vm->RegisterFunction("ResetAll", kScriptName.data(), ResetAll);
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -12,26 +15,10 @@
 #include <vector>
 
 #include "RE/B/BSFixedString.h"
+#include "core/ConfigCodec.h"
 
 namespace Config
 {
-enum class Type
-{
-	kBool,
-	kInteger,
-	kFloat,
-		kString
-	};
-
-	enum class ChangeSource
-	{
-		kFromIni,
-		kFromMCM,
-		kFromCode
-	};
-
-using Value = std::variant<bool, std::int64_t, double, std::string>;
-
 struct SettingDefinition
 {
 	std::string_view key;
@@ -49,6 +36,7 @@ struct Setting
 		Value defaultValue;
 		std::string description;
 		std::string section;
+		std::uint64_t changedGeneration{ 0 };  // Generation of the last change batch that touched this setting
 	};
 
 	class Manager
@@ -73,6 +61,24 @@ struct Setting
 
 		void SetValue(std::string_view key, Value value, ChangeSource source = ChangeSource::kFromCode, bool saveFile = true);
 
+		/// <summary>
+		/// Applies several values under a single lock and saves the file at most once. Values are coerced like in SetValue,
+		/// unknown keys are skipped. Returns the number of settings that changed.
+		/// </summary>
+		std::size_t SetValues(std::vector<std::pair<std::string, Value>> values, ChangeSource source = ChangeSource::kFromCode, bool saveFile = true);
+
+		struct Entry
+		{
+			std::string key;
+			Type type;
+			Value value;
+		};
+
+		/// <summary>
+		/// Returns all settings of a section sorted by key, or all settings if the section is empty.
+		/// </summary>
+		[[nodiscard]] std::vector<Entry> GetSectionValues(std::string_view section) const;
+
 		std::uint64_t AddListener(Listener listener);
 		void RemoveListener(std::uint64_t id);
 
@@ -80,22 +86,69 @@ struct Setting
 
 		void DispatchFullSyncEvent(ChangeSource source);
 
-	private:
-		static Type ResolveValueType(const Value& value);
-		static std::string SerializeValue(const Value& value, Type type);
-		static std::optional<Value> DeserializeValue(Type type, std::string_view raw);
-		static std::string_view TypeToString(Type type);
+		/// <summary>
+		/// Every batch of changes (a SetValues call, a reload, a reset) increments the generation and sends a single
+		/// ImmersiveCastingVR_ConfigBatch mod event carrying it. Readers then fetch the keys changed since the generation they last saw.
+		/// </summary>
+		[[nodiscard]] std::uint64_t GetGeneration() const;
+		[[nodiscard]] std::vector<std::string> GetChangedKeys(std::uint64_t sinceGeneration) const;
+
+		// Additionally send the legacy ImmersiveCastingVR_ConfigChanged event once per changed key. Off by default.
+		void SetPerKeyEventsEnabled(bool enabled) { _perKeyEvents.store(enabled, std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Profiles are ini files next to the main config named ImmersiveSpellcastingVR.<name>.ini, with the same layout. They may
+		/// contain only some settings. A profile is parsed once into an immutable snapshot (again only if the file changed) and
+		/// switching applies the snapshot as a single SetValues batch: one generation, one change event and one ini write.
+		/// Names may only contain letters, digits, '-' and '_'.
+		/// </summary>
+		bool SwitchProfile(std::string_view name, ChangeSource source = ChangeSource::kFromCode);
+
+		// Writes the current values of all settings to a profile, replacing the file if it exists
+		bool SaveProfile(std::string_view name);
 
-		void DispatchChangeEvent(std::string_view key, const Value& value, ChangeSource source);
+		// Sorted names of the profile files that currently exist
+		[[nodiscard]] std::vector<std::string> GetProfiles() const;
+
+		// Name of the last profile switched to, empty if none was used this session
+		[[nodiscard]] std::string GetActiveProfile() const;
+
+	private:
+		using ChangeSet = std::vector<std::pair<std::string, Value>>;
+
+		// Lets lookups by string_view probe the map without building a std::string key
+		struct KeyHash
+		{
+			using is_transparent = void;
+			std::size_t operator()(std::string_view key) const noexcept { return std::hash<std::string_view>{}(key); }
+		};
+
+		struct Profile
+		{
+			std::filesystem::file_time_type writeTime;
+			ChangeSet values;  // Already converted to the type of each setting
+		};
+
+		// generation is the one the batch was committed with, a later batch may already have bumped _generation
+		void DispatchChanges(const ChangeSet& changes, std::uint64_t generation, ChangeSource source);
 		void EnsureIniPath() const;
+		bool WriteIniFile(const std::filesystem::path& path) const;
+		[[nodiscard]] std::filesystem::path GetProfilePath(std::string_view name) const;
+		std::shared_ptr<const Profile> LoadProfile(std::string_view name);
 
 		mutable std::shared_mutex _mutex;
-		std::unordered_map<std::string, Setting> _settings;
+		std::unordered_map<std::string, Setting, KeyHash, std::equal_to<>> _settings;
 		std::filesystem::path _iniPath;
 		bool _loaded{ false };
+		std::uint64_t _generation{ 0 };
+		std::atomic<bool> _perKeyEvents{ false };
 
 		std::vector<std::pair<std::uint64_t, Listener>> _listeners;
 		std::uint64_t _nextListenerId{ 1 };
+
+		mutable std::mutex _profileMutex;
+		std::unordered_map<std::string, std::shared_ptr<const Profile>, KeyHash, std::equal_to<>> _profiles;
+		std::string _activeProfile;
 	};
 
 	bool RegisterPapyrusFunctions(RE::BSScript::IVirtualMachine* a_vm);
@@ -106,8 +159,10 @@ struct Setting
 template <class T>
 T Config::Manager::Get(std::string_view key, T fallback) const
 {
-	if (auto setting = GetSettingCopy(key)) {
-		if (auto value = std::get_if<T>(&setting->value)) {
+	// Only copies the value, not the whole setting with its description
+	std::shared_lock lock(_mutex);
+	if (const auto it = _settings.find(key); it != _settings.end()) {
+		if (auto value = std::get_if<T>(&it->second.value)) {
 			return *value;
 		}
 	}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "RE/Skyrim.h"
+#include "core/HandTracker.h"
+
+#include <array>
+#include <atomic>
 
 namespace HandOrientation
 {
@@ -13,26 +17,51 @@ namespace HandOrientation
         std::uint32_t slotIndex{ 0 };
     };
 
+    namespace detail
+    {
+        using Table = std::array<Info, 2>;  // Indexed by isPhysicalLeft
+
+        constexpr Info Make(bool physicalLeft, bool leftHandedMode)
+        {
+            const bool isMain = IsMainHand(physicalLeft, leftHandedMode);
+            Info info{};
+            info.isPhysicalLeft = physicalLeft;
+            info.isMainHand = isMain;
+            info.castingSource = isMain ? RE::MagicSystem::CastingSource::kRightHand : RE::MagicSystem::CastingSource::kLeftHand;
+            info.slotIndex = isMain ? 1u : 0u;
+            return info;
+        }
+
+        // Precomputed tables for right- and left-handed mode, so the hot paths never have to query the game setting.
+        inline constexpr std::array<Table, 2> kTables{
+            Table{ Make(false, false), Make(true, false) },
+            Table{ Make(false, true), Make(true, true) }
+        };
+
+        inline std::atomic<const Table*> g_activeTable{ &kTables[0] };
+    }
+
+    /// <summary>
+    /// Re-reads the left-handed mode setting and switches the orientation table if it changed. Returns true on a change.
+    /// Must be called after anything that can change the setting (loading a save, closing menus).
+    /// </summary>
+    inline bool Refresh()
+    {
+        const auto* table = &detail::kTables[RE::BSOpenVRControllerDevice::IsLeftHandedMode() ? 1 : 0];
+        return detail::g_activeTable.exchange(table, std::memory_order_relaxed) != table;
+    }
+
     inline Info FromPhysical(bool physicalLeft)
     {
-        const bool isMain = RE::BSOpenVRControllerDevice::IsLeftHandedMode() ? physicalLeft : !physicalLeft;
-        Info info{};
-        info.isPhysicalLeft = physicalLeft;
-        info.isMainHand = isMain;
-        info.castingSource = isMain ? RE::MagicSystem::CastingSource::kRightHand : RE::MagicSystem::CastingSource::kLeftHand;
-        info.slotIndex = isMain ? 1u : 0u;
-        return info;
+        return (*detail::g_activeTable.load(std::memory_order_relaxed))[physicalLeft ? 1 : 0];
     }
 
     inline Info FromCastingSource(RE::MagicSystem::CastingSource source)
     {
         const bool isMain = (source == RE::MagicSystem::CastingSource::kRightHand);
-        const bool physicalLeft = RE::BSOpenVRControllerDevice::IsLeftHandedMode() ? isMain : !isMain;
-        Info info{};
-        info.isPhysicalLeft = physicalLeft;
-        info.isMainHand = isMain;
+        const auto& table = *detail::g_activeTable.load(std::memory_order_relaxed);
+        Info info = table[table[1].isMainHand == isMain ? 1 : 0];
         info.castingSource = source;
-        info.slotIndex = isMain ? 1u : 0u;
         return info;
     }
 }
@@ -5,9 +5,14 @@
 #include "InputDispatcher.h"
 #include "CasterStateTracker.h"
 #include "HandOrientation.h"
+#include "core/AllocAudit.h"
+#include "core/FlightRecorder.h"
+#include "core/Metrics.h"
+#include "utils/TaskPool.h"
 
 #include <atomic>
 #include <chrono>
+#include <format>
 #include <thread>
 
 
@@ -19,15 +24,48 @@ namespace InputDispatcher
 	{
 		std::uint64_t g_casterStateListenerId{ 0 };
 
-		bool IsStateActive(SpellChargeTracker::ActualState state)
+		constexpr std::uint32_t kMaxAnomalyDumps = 5;
+		std::atomic<std::uint32_t> g_anomalyDumps{ 0 };
+
+		void DumpAnomaly(bool physicalLeft, Recorder::AnomalyKind anomaly, std::uint32_t detail)
 		{
-			return !(state == SpellChargeTracker::ActualState::kIdle || state == SpellChargeTracker::ActualState::kReleasing);
+			auto& recorder = Recorder::ForHand(physicalLeft);
+			recorder.Record(Recorder::RecordType::kAnomaly, static_cast<std::uint8_t>(anomaly), 0, detail);
+
+			const auto index = g_anomalyDumps.fetch_add(1, std::memory_order_relaxed);
+			if (index >= kMaxAnomalyDumps) {
+				return;
+			}
+
+			auto path = logger::log_directory();
+			if (!path) {
+				return;
+			}
+
+			*path /= std::format("{}_flight_{}_{}.bin", g_pluginNameShort, physicalLeft ? "left" : "right", index);
+			if (recorder.Dump(*path, anomaly)) {
+				logger::warn("{} hand did not reach the declared caster state after {} retries, stopped retrying, flight recorder dumped to {}", physicalLeft ? "Left" : "Right", detail, path->string());
+			} else {
+				logger::error("Failed to write flight recorder dump {}", path->string());
+			}
 		}
 
 		void HandleCasterStateChanged(const CasterStateTracker::StateChangedEvent& event)
 		{
-			auto& dispatcher = event.orientation.isPhysicalLeft ? leftDisp : rightDisp;
-			dispatcher.OnCasterStateChanged();
+			// Both hands wait for shouts to finish
+			if (event.IsVoice()) {
+				leftDisp.OnCasterStateChanged();
+				rightDisp.OnCasterStateChanged();
+				return;
+			}
+
+			// A dual cast event wakes both hands at once
+			if (event.AffectsHand(true)) {
+				leftDisp.OnCasterStateChanged();
+			}
+			if (event.AffectsHand(false)) {
+				rightDisp.OnCasterStateChanged();
+			}
 		}
 
 		struct StateListenerRegistrar
@@ -81,6 +119,7 @@ namespace InputDispatcher
 	void _AddAttackButtonEvent(bool isMainHand, bool pressed, float heldSecOverride = 0.0f)
 	{
 		if (inputSuppressed.load(std::memory_order_relaxed) && pressed) {
+			Metrics::Increment(Metrics::Counter::kSuppressedInputs);
 			return;
 		}
 
@@ -102,10 +141,15 @@ namespace InputDispatcher
 			heldSec,                                  // 0.0 new press; >0.0 signals release
 			isMainHand ? ue->rightAttack : ue->leftAttack
 		);
+		Metrics::Increment(Metrics::Counter::kAttackEventsInjected);
+		const auto orientation = HandOrientation::FromCastingSource(isMainHand ? RE::MagicSystem::CastingSource::kRightHand : RE::MagicSystem::CastingSource::kLeftHand);
+		Recorder::ForHand(orientation.isPhysicalLeft).Record(Recorder::RecordType::kInjected, pressed, isMainHand, static_cast<std::uint32_t>(heldSec * 1'000'000.0f));
 	}
 
-	HandInputDispatcher::HandInputDispatcher(bool isLeftHand) :
-		isLeftHand(isLeftHand)
+	HandInputDispatcher::HandInputDispatcher(bool isLeftHand, Utils::Clock& clock) :
+		TimedWorker(clock),
+		isLeftHand(isLeftHand),
+		stateMachine(clock.Now())
 	{
 		handName = isLeftHand ? "Left" : "Right";
 		currentCasterState = isLeftHand ? &SpellChargeTracker::lastLeftHandState : &SpellChargeTracker::lastRightHandState;
@@ -126,32 +170,53 @@ namespace InputDispatcher
 	}
 
 	void HandInputDispatcher::DeclareCasterState(bool casterActive) {
-		// Store state if it changed
-		const bool kOldCasterActive = casterDeclaredActive.exchange(casterActive, std::memory_order_relaxed);
-
-		// If it changed, trigger a dispatch now and set the minInterval to 20ms to ensure it goes through.
-		// Inputs typically take 10ms to result in a changed caster state so 20ms should be pretty efficient in case a repress is needed.
-		if (kOldCasterActive != casterActive) {
-			casterDeclarationChanged = true;
-		}
+		// Store state, if it changed the next dispatch sends the input right away and keeps retrying until it goes through.
+		stateMachine.Declare(casterActive);
+		Recorder::ForHand(isLeftHand).Record(Recorder::RecordType::kDeclared, casterActive);
 
 		RequestWork();
 	}
 
 	void HandInputDispatcher::SuppressUntilCasterInactive()
 	{
-		suppressUntilCasterInactive.store(true);
+		stateMachine.SuppressUntilCasterInactive();
+	}
+
+	namespace
+	{
+		struct AttackButtonArgs
+		{
+			InjectionGate* gate;
+			bool isMainHand;
+			bool pressed;
+			float heldSecOverride;
+		};
+
+		Utils::TaskPool<AttackButtonArgs> g_attackButtonTasks{ [](const AttackButtonArgs& args) {
+			args.gate->OnRun();
+			_AddAttackButtonEvent(args.isMainHand, args.pressed, args.heldSecOverride);
+		} };
 	}
 
 	void HandInputDispatcher::AddAttackButtonEvent(bool isMainHand, bool pressed, float heldSecOverride)
 	{
-		//auto time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
-		//logger::trace("{}: {} {}", time, left ? "Left" : "Right", pressed ? "press" : "unpress");
-		SKSE::GetTaskInterface()->AddUITask([isMainHand, pressed, heldSecOverride]() { _AddAttackButtonEvent(isMainHand, pressed, heldSecOverride); });
+		// A stalled UI thread (loading, menus that block tasks) must not pile up re-presses that all fire at once afterwards
+		const auto admission = injectionGate.Admit(pressed);
+		if (admission != InjectionGate::Admission::kQueue) {
+			const bool merged = admission == InjectionGate::Admission::kMerge;
+			Metrics::Increment(merged ? Metrics::Counter::kInjectionsMerged : Metrics::Counter::kInjectionsDropped);
+			Recorder::ForHand(isLeftHand).Record(Recorder::RecordType::kSkipped, pressed, static_cast<std::uint8_t>(admission), injectionGate.Pending());
+			ISPVR_LOG_TRACE("{} hand {} {}", isMainHand ? "Main" : "Off", pressed ? "press" : "unpress", merged ? "merged" : "dropped");
+			return;
+		}
+
+		ISPVR_LOG_TRACE("{} hand {}", isMainHand ? "Main" : "Off", pressed ? "press" : "unpress");
+		g_attackButtonTasks.AddUITask({ .gate = &injectionGate, .isMainHand = isMainHand, .pressed = pressed, .heldSecOverride = heldSecOverride });
 	}
 
 	void HandInputDispatcher::Work()
 	{
+		ISPVR_ALLOC_AUDIT_SCOPE("HandInputDispatcher::Work");
 		const bool scheduledRun = workScheduled.exchange(false, std::memory_order_relaxed);
 		const bool timedRun = minInterval.load(std::memory_order_relaxed).count() > 0;
 		if (!scheduledRun && !timedRun) {
@@ -167,46 +232,31 @@ namespace InputDispatcher
 			return;
 		}
 
-		// return if player is shouting and wait for shout to stop
-		if (player->GetMagicCaster(RE::MagicSystem::CastingSource::kOther)->state != RE::MagicCaster::State::kNone) {
-			minInterval.store(std::chrono::milliseconds(20), std::memory_order_relaxed);
-			return;
-		}
-
-		const bool kCasterDesiredActive = casterDeclaredActive.load(std::memory_order_relaxed);
-		const SpellChargeTracker::ActualState kCasterState = currentCasterState->load(std::memory_order_relaxed);
-		const bool kCasterActive = IsStateActive(kCasterState);
-
-		if (suppressUntilCasterInactive.load(std::memory_order_relaxed)) {
-			if (kCasterDesiredActive) {
-				minInterval.store(std::chrono::milliseconds(0), std::memory_order_relaxed);
+		// return if player is shouting and wait for shout to stop. The voice caster state event wakes the dispatcher once the shout is over.
+		const auto voiceState = CasterStateTracker::lastVoiceState.load(std::memory_order_relaxed);
+		if (voiceState == CasterStateTracker::ActualState::kUnknown) {
+			// Tracker hasn't seen the voice caster yet, fall back to polling it
+			if (player->GetMagicCaster(RE::MagicSystem::CastingSource::kOther)->state != RE::MagicCaster::State::kNone) {
+				minInterval.store(std::chrono::milliseconds(20), std::memory_order_relaxed);
 				return;
 			}
-			suppressUntilCasterInactive.store(false, std::memory_order_relaxed);
-		}
-
-		if (kCasterActive == kCasterDesiredActive && !casterDeclarationChanged.load(std::memory_order_relaxed)) {
+		} else if (voiceState != CasterStateTracker::ActualState::kIdle) {
 			minInterval.store(std::chrono::milliseconds(0), std::memory_order_relaxed);
 			return;
 		}
 
-		minInterval.store(std::chrono::milliseconds(20), std::memory_order_relaxed);
-		const auto now = std::chrono::steady_clock::now();
+		const auto casterState = currentCasterState->load(std::memory_order_relaxed);
+		const auto decision = stateMachine.Step(casterState, clock.Now());
+		minInterval.store(decision.nextInterval, std::memory_order_relaxed);
 
-		if (casterDeclarationChanged.exchange(false, std::memory_order_relaxed)) {
-			currentInputStartTime = now;
-			this->AddAttackButtonEvent(orientation.isMainHand, kCasterDesiredActive);
-			return;
+		if (decision.sendInput) {
+			Recorder::ForHand(isLeftHand).Record(Recorder::RecordType::kDecision, decision.pressed, static_cast<std::uint8_t>(static_cast<int>(casterState) + 1), decision.retries);
+			this->AddAttackButtonEvent(orientation.isMainHand, decision.pressed, decision.heldSecOverride);
 		}
 
-		const auto elapsed = now - currentInputStartTime;
-		if (elapsed <= kGracePeriod) {
-			this->AddAttackButtonEvent(orientation.isMainHand, kCasterDesiredActive, std::chrono::duration<float>(elapsed).count());
-			return;
+		if (decision.gaveUp) {
+			DumpAnomaly(isLeftHand, Recorder::AnomalyKind::kNoConvergence, decision.retries);
 		}
-
-		this->AddAttackButtonEvent(orientation.isMainHand, kCasterDesiredActive);
-		currentInputStartTime = now;
 	}
 
 
@@ -215,12 +265,14 @@ namespace InputDispatcher
 
 	void Pause(bool paused)
 	{
-		if (paused) {
-			leftDisp.Stop();
-			rightDisp.Stop();
-		} else {
-			leftDisp.Start();
-			rightDisp.Start();
-		}
+		leftDisp.Pause(paused);
+		rightDisp.Pause(paused);
+	}
+
+	void SetFrameAligned(bool enabled)
+	{
+		auto* frames = enabled ? &Utils::FrameClock::Get() : nullptr;
+		leftDisp.SetFrameClock(frames);
+		rightDisp.SetFrameClock(frames);
 	}
 }
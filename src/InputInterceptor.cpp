@@ -18,6 +18,7 @@
 #include "math.h"
 #include "InputInterceptor.h"
 #include "HandOrientation.h"
+#include "core/FlightRecorder.h"
 
 namespace InputInterceptor
 {
@@ -105,6 +106,8 @@ namespace InputInterceptor
 			}
 
 
+			Recorder::ForHand(isLeftHand).Record(Recorder::RecordType::kGrip, castingButtonActivated, forceDispatch);
+
 			auto player = RE::PlayerCharacter::GetSingleton();
 			const auto orientation = HandOrientation::FromPhysical(isLeftHand);
 			InputDispatcher::HandInputDispatcher& kDispatcher = (isLeftHand ? InputDispatcher::leftDisp : InputDispatcher::rightDisp);
@@ -17,5 +17,12 @@ namespace Settings
 
 	inline constexpr auto kHapticsEnable = "HapticsEnable"sv;
 
+	inline constexpr auto kAdvancedFrameAlignedWorkers = "FrameAlignedWorkers"sv;
+
+	inline constexpr auto kBalancingRebalanceChargeTimes = "RebalanceChargeTimes"sv;
+	inline constexpr auto kBalancingAimedChargeSeconds = "RemovedAimedChargeSeconds"sv;
+	inline constexpr auto kBalancingSelfChargeSeconds = "RemovedSelfChargeSeconds"sv;
+	inline constexpr auto kBalancingReleaseSeconds = "RemovedReleaseSeconds"sv;
+
 	std::span<const Config::SettingDefinition> GetSettingDefinitions();
 }
@@ -3,12 +3,17 @@
 #include "CasterStateTracker.h"
 #include "ConfigManager.h"
 #include "Settings.h"
+#include "SpellMetadata.h"
 #include "compat/HapticSkyrimVR.h"
+#include "core/HapticFeed.h"
 #include "haptics.h"
 #include "utils.h"
+#include "utils/TimedWorker.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cmath>
+#include <memory>
 
 namespace SpellChargeTracker
 {
@@ -19,6 +24,10 @@ namespace SpellChargeTracker
 		std::atomic_bool g_hapticsEnabled{ true };
 		std::uint64_t g_configListenerId{ 0 };
 		std::uint64_t g_stateListenerId{ 0 };
+		std::uint64_t g_chargeListenerId{ 0 };
+
+		// Granularity of the charge haptics ramp
+		constexpr std::uint32_t kChargeSteps = 64;
 		bool g_installed{ false };
 
 		void StopAllHaptics()
@@ -61,39 +70,37 @@ namespace SpellChargeTracker
 				});
 		}
 
-		void HandleStateChanged(const CasterStateTracker::StateChangedEvent& event)
+		void ScheduleChargeHaptics(Haptics::HandHaptics* handHaptics, float chargeProgress, bool interrupt)
 		{
-			if (!g_hapticsEnabled.load(std::memory_order_relaxed)) {
-				return;
-			}
+			handHaptics->ScheduleEvent({
+				.pulseInterval = static_cast<int>(std::lerp(100.0f, 20.0f, chargeProgress)),
+				.pulseStrength = static_cast<float>(std::lerp(0.0f, 1.0f, std::pow(chargeProgress, 6.0f))),
+				.pulses = 0,
+				.interruptPulse = interrupt
+			});
+		}
 
-			auto* caster = event.caster;
+		bool IsPlayerCaster(const RE::ActorMagicCaster* caster)
+		{
 			auto* player = RE::PlayerCharacter::GetSingleton();
-			if (!caster || !player || caster->actor != player) {
-				return;
-			}
+			return caster && player && caster->actor == player;
+		}
 
-			auto* handHaptics = Haptics::GetHandHaptics(event.orientation.isPhysicalLeft);
+		void ApplyStateHaptics(bool physicalLeft, ActualState previousState, ActualState newState, RE::PlayerCharacter* player)
+		{
+			auto* handHaptics = Haptics::GetHandHaptics(physicalLeft);
 			if (!handHaptics) {
 				return;
 			}
 
-			const auto newState = event.currentState;
-			const auto previousState = event.previousState;
-
 			if (newState == ActualState::kIdle) {
 				handHaptics->ScheduleEvent({});
 				return;
 			}
 
-			if (newState == ActualState::kStart || newState == ActualState::kCharging) {
-				const float chargeProgress = (newState == ActualState::kCharging) ? (1.0f - (caster->castingTimer * 2.0f)) : 0.0f;
-				handHaptics->ScheduleEvent({
-					.pulseInterval = static_cast<int>(std::lerp(100.0f, 20.0f, chargeProgress)),
-					.pulseStrength = static_cast<float>(std::lerp(0.0f, 1.0f, std::pow(chargeProgress, 6.0f))),
-					.pulses = 0,
-					.interruptPulse = (newState == ActualState::kStart)
-				});
+			// The ramp while charging is driven by the charge progress events. If the feed coalesced kStart away, kCharging starts it.
+			if (newState == ActualState::kStart || (newState == ActualState::kCharging && previousState != ActualState::kStart)) {
+				ScheduleChargeHaptics(handHaptics, 0.0f, true);
 				return;
 			}
 
@@ -103,9 +110,10 @@ namespace SpellChargeTracker
 			}
 
 			if (newState == ActualState::kReleasing) {
-				auto* spell = static_cast<RE::SpellItem*>(player->GetEquippedObject(!event.orientation.isMainHand));
+				const auto orientation = HandOrientation::FromPhysical(physicalLeft);
+				auto* spell = static_cast<RE::SpellItem*>(player->GetEquippedObject(!orientation.isMainHand));
 				const bool interrupt = previousState != ActualState::kReleasing;
-				if (Utils::InvertVRInputForSpell(spell)) {
+				if (SpellMetadata::Get(spell).hapticProfile == Spells::HapticProfile::kConcentration) {
 					handHaptics->ScheduleEvent({ 30, 1, 0, interrupt });
 				} else {
 					handHaptics->ScheduleEvent({ 10, 1, 10, interrupt, false });
@@ -114,13 +122,98 @@ namespace SpellChargeTracker
 			}
 		}
 
+		/// <summary>
+		/// Carries the state and charge events of the player's hands to a worker thread. Both listeners run inline and only post
+		/// to the feed's mailbox, so the two streams stay in order and the main thread never takes the haptics locks.
+		/// </summary>
+		class HapticsFeed : public Utils::TimedWorker
+		{
+		public:
+			HapticsFeed()
+			{
+				minInterval.store(std::chrono::milliseconds(0), std::memory_order::relaxed);
+				Start();
+			}
+
+			~HapticsFeed() override
+			{
+				Stop();
+			}
+
+			void PostState(bool physicalLeft, ActualState previousState, ActualState currentState)
+			{
+				if (mailbox.PostState(physicalLeft, previousState, currentState)) {
+					Notify();
+				}
+			}
+
+			void PostCharge(bool physicalLeft, float progress)
+			{
+				const auto step = static_cast<std::uint8_t>(std::lround(std::clamp(progress, 0.0f, 1.0f) * kChargeSteps));
+				if (mailbox.PostCharge(physicalLeft, step)) {
+					Notify();
+				}
+			}
+
+		private:
+			void Work() override
+			{
+				auto* player = RE::PlayerCharacter::GetSingleton();
+				for (const bool physicalLeft : { true, false }) {
+					const auto update = mailbox.Take(physicalLeft);
+					if (!update || !player || !g_hapticsEnabled.load(std::memory_order_relaxed)) {
+						continue;
+					}
+
+					if (update->hasState) {
+						ApplyStateHaptics(physicalLeft, update->previousState, update->currentState, player);
+					}
+					if (update->hasCharge) {
+						if (auto* handHaptics = Haptics::GetHandHaptics(physicalLeft)) {
+							ScheduleChargeHaptics(handHaptics, static_cast<float>(update->chargeStep) / kChargeSteps, false);
+						}
+					}
+				}
+			}
+
+			Haptics::FeedMailbox mailbox;
+		};
+
+		std::unique_ptr<HapticsFeed> g_feed;
+
+		void HandleChargeProgress(const CasterStateTracker::ChargeProgressEvent& event)
+		{
+			if (!g_hapticsEnabled.load(std::memory_order_relaxed) || !IsPlayerCaster(event.caster)) {
+				return;
+			}
+
+			g_feed->PostCharge(event.orientation.isPhysicalLeft, event.progress);
+		}
+
+		void HandleStateChanged(const CasterStateTracker::StateChangedEvent& event)
+		{
+			if (!g_hapticsEnabled.load(std::memory_order_relaxed) || event.IsVoice() || !IsPlayerCaster(event.caster)) {
+				return;
+			}
+
+			// Dual cast events carry both hands
+			for (const bool physicalLeft : { true, false }) {
+				if (event.AffectsHand(physicalLeft)) {
+					g_feed->PostState(physicalLeft, event.previousState, event.currentState);
+				}
+			}
+		}
+
 		void EnsureStateListener()
 		{
 			if (g_stateListenerId != 0) {
 				return;
 			}
 
+			// Both streams go through the same feed so they stay in order, see HapticsFeed
+			g_feed = std::make_unique<HapticsFeed>();
 			g_stateListenerId = CasterStateTracker::AddListener(HandleStateChanged);
+			g_chargeListenerId = CasterStateTracker::AddChargeListener(HandleChargeProgress, kChargeSteps);
 		}
 	}  // namespace
 
@@ -0,0 +1,113 @@
+#include "SpellMetadata.h"
+
+#include "RE/T/TESDataHandler.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace SpellMetadata
+{
+	namespace
+	{
+		// Readers take a reference with a single atomic load, a replaced table is freed by whoever drops the last reference
+		std::atomic<std::shared_ptr<const Spells::SpellTable>> g_table;
+
+		Spells::SpellSource ToSource(const RE::SpellItem* spell, bool learnable)
+		{
+			return {
+				.formID = spell->GetFormID(),
+				.spellType = static_cast<Spells::SpellType>(spell->GetSpellType()),
+				.castingType = static_cast<Spells::CastingType>(spell->GetCastingType()),
+				.delivery = static_cast<Spells::Delivery>(spell->GetDelivery()),
+				.chargeTime = spell->data.chargeTime,
+				.learnable = learnable,
+				.name = spell->GetName(),
+			};
+		}
+
+		// Spells the player can get: taught by a spell tome or in the player's starting spell list. Everything else is NPC only.
+		std::unordered_set<RE::FormID> CollectLearnableSpells(RE::TESDataHandler* dataHandler)
+		{
+			std::unordered_set<RE::FormID> learnable;
+			for (const auto* book : dataHandler->GetFormArray<RE::TESObjectBOOK>()) {
+				if (book && book->TeachesSpell()) {
+					if (const auto* spell = book->GetSpell()) {
+						learnable.insert(spell->GetFormID());
+					}
+				}
+			}
+
+			const auto* player = RE::PlayerCharacter::GetSingleton();
+			const auto* playerBase = player ? player->GetActorBase() : nullptr;
+			const auto* spellData = playerBase ? playerBase->actorEffects : nullptr;
+			if (spellData && spellData->spells) {
+				for (std::uint32_t i = 0; i < spellData->numSpells; ++i) {
+					if (const auto* spell = spellData->spells[i]) {
+						learnable.insert(spell->GetFormID());
+					}
+				}
+			}
+			return learnable;
+		}
+	}
+
+	void Refresh()
+	{
+		auto* dataHandler = RE::TESDataHandler::GetSingleton();
+		if (!dataHandler) {
+			logger::error("SpellMetadata: data handler not available, table not built");
+			return;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+
+		// Reading the forms is cheap, describing and sorting them is what runs in parallel
+		const auto learnable = CollectLearnableSpells(dataHandler);
+		const auto previous = g_table.load(std::memory_order_acquire);
+		const auto& spells = dataHandler->GetFormArray<RE::SpellItem>();
+		std::vector<Spells::SpellSource> sources;
+		sources.reserve(spells.size());
+		for (const auto* spell : spells) {
+			if (!spell) {
+				continue;
+			}
+
+			auto source = ToSource(spell, learnable.contains(spell->GetFormID()));
+			// The live charge time may have been rebalanced since the spell was first described
+			if (const auto* known = previous ? previous->Find(source.formID) : nullptr) {
+				source.chargeTime = known->chargeTime;
+			}
+			sources.push_back(source);
+		}
+
+		auto table = std::make_shared<const Spells::SpellTable>(Spells::SpellTable::Build(sources));
+		const auto size = table->Size();
+		g_table.store(std::move(table), std::memory_order_release);
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		logger::info("SpellMetadata: described {} spells in {} us", size, elapsed.count());
+	}
+
+	Spells::SpellInfo Get(const RE::SpellItem* spell)
+	{
+		if (!spell) {
+			return {};
+		}
+
+		if (const auto table = g_table.load(std::memory_order_acquire)) {
+			if (const auto* info = table->Find(spell->GetFormID())) {
+				return *info;
+			}
+		}
+		// Not worth a learnable lookup, only the charge rebalancing cares and it works from the table
+		return Spells::Describe(ToSource(spell, false));
+	}
+
+	std::shared_ptr<const Spells::SpellTable> GetTable()
+	{
+		return g_table.load(std::memory_order_acquire);
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "RE/Skyrim.h"
+
+#include <memory>
+
+#include "core/SpellTable.h"
+
+namespace SpellMetadata
+{
+	/// <summary>
+	/// Rebuilds the table from all loaded spell forms and swaps it in. Called at kDataLoaded, call again after spells were
+	/// added or changed. Charge times are taken as the spells were loaded: a spell that is already in the table keeps its charge
+	/// time, so the charge rebalancing never ends up in the table. Must run on the main thread.
+	/// </summary>
+	void Refresh();
+
+	/// <summary>
+	/// Looks a spell up in the current table, lock free. Spells that are not in it (created at runtime, or looked up before the
+	/// table was built) are described from the game data on the spot.
+	/// </summary>
+	Spells::SpellInfo Get(const RE::SpellItem* spell);
+
+	// Current table, nullptr before the first Refresh. A replaced table is freed once the last holder lets go of it.
+	std::shared_ptr<const Spells::SpellTable> GetTable();
+}
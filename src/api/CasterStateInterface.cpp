@@ -0,0 +1,56 @@
+#include "api/CasterStateInterface.h"
+
+#include "SKSE/SKSE.h"
+#include "CasterStateTracker.h"
+#include "api/CasterStateInterface001.h"
+
+namespace Api::CasterState
+{
+	namespace
+	{
+		constexpr unsigned int kBuildNumber = 1;
+
+		class CasterStateInterface001 final : public ISPVRApi::ICasterStateInterface001
+		{
+		public:
+			unsigned int GetBuildNumber() override { return kBuildNumber; }
+
+			bool Read(ISPVRApi::CasterStateSnapshot& out) override { return CasterStateTracker::GetSnapshot().Read(out); }
+
+			std::uint32_t GetSequence() override { return CasterStateTracker::GetSnapshot().Sequence(); }
+		};
+
+		CasterStateInterface001 g_interface001;
+
+		void* GetApi(unsigned int revisionNumber)
+		{
+			switch (revisionNumber) {
+			case 1:
+				return &g_interface001;
+			default:
+				return nullptr;
+			}
+		}
+
+		void OnPluginMessage(SKSE::MessagingInterface::Message* msg)
+		{
+			if (msg->type != ISPVRApi::CasterStateInterfaceRequest::kMessage_GetInterface || !msg->data || msg->dataLen < sizeof(void*)) {
+				return;
+			}
+
+			auto* request = static_cast<ISPVRApi::CasterStateInterfaceRequest*>(msg->data);
+			request->GetApiFunction = GetApi;
+			logger::info("Caster state API: interface requested by {}", msg->sender ? msg->sender : "unknown plugin");
+		}
+	}
+
+	bool Install()
+	{
+		// A null sender registers for messages from all plugins
+		if (!SKSE::GetMessagingInterface()->RegisterListener(nullptr, OnPluginMessage)) {
+			logger::error("Caster state API: failed to register message listener");
+			return false;
+		}
+		return true;
+	}
+}
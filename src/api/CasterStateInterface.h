@@ -0,0 +1,9 @@
+#pragma once
+
+namespace Api::CasterState
+{
+	/// <summary>
+	/// Starts answering caster state interface requests from other plugins. Must be called while the plugin is loading.
+	/// </summary>
+	bool Install();
+}
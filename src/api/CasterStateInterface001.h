@@ -0,0 +1,61 @@
+#pragma once
+
+// Public caster state interface of ImmersiveSpellcastingVR. This header only needs the standard library and can be copied into
+// other plugins.
+//
+// Fetching the interface (after kPostLoad):
+//   ISPVRApi::CasterStateInterfaceRequest request;
+//   messaging->Dispatch(ISPVRApi::CasterStateInterfaceRequest::kMessage_GetInterface, &request, sizeof(request), nullptr);
+//   auto* casters = request.GetApiFunction ? static_cast<ISPVRApi::ICasterStateInterface001*>(request.GetApiFunction(1)) : nullptr;
+
+#include <cstdint>
+
+namespace ISPVRApi
+{
+	// Message used to fetch the interface. Passing nullptr as receiver broadcasts it, ImmersiveSpellcastingVR answers any sender.
+	struct CasterStateInterfaceRequest
+	{
+		enum
+		{
+			kMessage_GetInterface = 0x49535643  // "ISVC"
+		};
+
+		// Returns the interface for the given revision, nullptr if it is not supported
+		void* (*GetApiFunction)(unsigned int revisionNumber) = nullptr;
+	};
+
+	/// <summary>
+	/// State of the player's spell casters, written by ImmersiveSpellcastingVR from its caster update hook.
+	/// </summary>
+	struct CasterStateSnapshot
+	{
+		struct Hand
+		{
+			std::int32_t state = -1;  // RE::MagicCaster::State of the hand's caster, -1 if unknown
+			float chargeProgress = 0;  // 0..1 while charging, 1 while a charged spell is held, 0 otherwise
+			std::uint32_t spellFormID = 0;  // Spell in the caster, 0 if none
+			std::uint32_t reserved = 0;
+		};
+
+		Hand hands[2];  // Indexed by physical hand, 0 = left, 1 = right. Left-handed mode is already accounted for.
+		std::uint32_t dualCasting = 0;  // 1 while both hands cast one spell together
+		std::uint32_t reserved = 0;
+		std::uint64_t frame = 0;  // Game frame the snapshot was written in, increases by one per frame
+	};
+
+	/// <summary>
+	/// Lets other plugins poll the player's caster state without hooking the casters themselves. Reads are lock free and never
+	/// block the game thread, they can be done from any thread at any rate.
+	/// </summary>
+	class ICasterStateInterface001
+	{
+	public:
+		virtual unsigned int GetBuildNumber() = 0;
+
+		// Copies the latest snapshot. Returns false if no consistent copy could be made (the game was writing it on every attempt).
+		virtual bool Read(CasterStateSnapshot& out) = 0;
+
+		// Changes whenever a new snapshot is written. Compare it to the last value to skip reading an unchanged snapshot.
+		virtual std::uint32_t GetSequence() = 0;
+	};
+}
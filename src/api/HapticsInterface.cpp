@@ -0,0 +1,87 @@
+#include "api/HapticsInterface.h"
+
+#include "SKSE/SKSE.h"
+#include "api/HapticsInterface001.h"
+#include "haptics.h"
+
+namespace Api::Haptics
+{
+	namespace
+	{
+		constexpr unsigned int kBuildNumber = 1;
+
+		class HapticsInterface001 final : public ISPVRApi::IHapticsInterface001
+		{
+		public:
+			unsigned int GetBuildNumber() override { return kBuildNumber; }
+
+			int OpenChannel(int priority, float maxStrength) override
+			{
+				const int channel = ::Haptics::AddChannel(priority, maxStrength);
+				if (channel < 0) {
+					logger::warn("Haptics API: no channel left for a priority {} source", priority);
+				} else {
+					logger::info("Haptics API: opened channel {} (priority {}, max strength {})", channel, priority, maxStrength);
+				}
+				return channel;
+			}
+
+			void Submit(int channel, bool leftHand, const ISPVRApi::HapticPulseEvent& event) override
+			{
+				// The spell channel belongs to the mod itself
+				if (channel == ::Haptics::kSpellChannel) {
+					return;
+				}
+
+				if (auto* hand = ::Haptics::GetHandHaptics(leftHand)) {
+					hand->ScheduleEvent(channel, {
+						.pulseInterval = event.pulseInterval,
+						.pulseStrength = event.pulseStrength,
+						.pulses = event.pulses,
+						.interruptPulse = event.interruptPulse,
+						.remainAfterCompletion = event.remainAfterCompletion,
+						.replaceScheduledEvents = event.replaceScheduledEvents,
+					});
+				}
+			}
+
+			void Stop(int channel, bool leftHand) override
+			{
+				Submit(channel, leftHand, { .interruptPulse = true });
+			}
+		};
+
+		HapticsInterface001 g_interface001;
+
+		void* GetApi(unsigned int revisionNumber)
+		{
+			switch (revisionNumber) {
+			case 1:
+				return &g_interface001;
+			default:
+				return nullptr;
+			}
+		}
+
+		void OnPluginMessage(SKSE::MessagingInterface::Message* msg)
+		{
+			if (msg->type != ISPVRApi::InterfaceRequest::kMessage_GetInterface || !msg->data || msg->dataLen < sizeof(void*)) {
+				return;
+			}
+
+			auto* request = static_cast<ISPVRApi::InterfaceRequest*>(msg->data);
+			request->GetApiFunction = GetApi;
+			logger::info("Haptics API: interface requested by {}", msg->sender ? msg->sender : "unknown plugin");
+		}
+	}
+
+	bool Install()
+	{
+		// A null sender registers for messages from all plugins
+		if (!SKSE::GetMessagingInterface()->RegisterListener(nullptr, OnPluginMessage)) {
+			logger::error("Haptics API: failed to register message listener");
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace Api::Haptics
+{
+	/// <summary>
+	/// Starts answering interface requests from other plugins. Must be called while the plugin is loading.
+	/// </summary>
+	bool Install();
+}
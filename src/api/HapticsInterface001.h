@@ -0,0 +1,54 @@
+#pragma once
+
+// Public haptics interface of ImmersiveSpellcastingVR. This header has no dependencies and can be copied into other plugins.
+//
+// Fetching the interface (after kPostLoad):
+//   ISPVRApi::InterfaceRequest request;
+//   messaging->Dispatch(ISPVRApi::InterfaceRequest::kMessage_GetInterface, &request, sizeof(request), nullptr);
+//   auto* haptics = request.GetApiFunction ? static_cast<ISPVRApi::IHapticsInterface001*>(request.GetApiFunction(1)) : nullptr;
+
+namespace ISPVRApi
+{
+	// Message used to fetch the interface. Passing nullptr as receiver broadcasts it, ImmersiveSpellcastingVR answers any sender.
+	struct InterfaceRequest
+	{
+		enum
+		{
+			kMessage_GetInterface = 0x49535056  // "ISPV"
+		};
+
+		// Returns the interface for the given revision, nullptr if it is not supported
+		void* (*GetApiFunction)(unsigned int revisionNumber) = nullptr;
+	};
+
+	struct HapticPulseEvent
+	{
+		int pulseInterval = 0;  // Milliseconds between pulses, at least 5
+		float pulseStrength = 0;  // 0..1
+		int pulses = 0;  // The (minimum) number of pulses to perform
+
+		bool interruptPulse = false;  // Skip all active/queued pulses of the channel and play this event immediately
+		bool remainAfterCompletion = true;  // Keep pulsing with these parameters after the event completed, until a new event is submitted
+		bool replaceScheduledEvents = true;  // Drop events queued on the channel before this one
+	};
+
+	/// <summary>
+	/// Lets other plugins submit haptic events to the controllers. Every plugin opens its own channel, the channels of a hand are
+	/// mixed into a single pulse stream: running channels mute channels with a lower priority, equal priorities blend to the
+	/// strongest pulse. The spell charge haptics use priority 0.
+	/// </summary>
+	class IHapticsInterface001
+	{
+	public:
+		virtual unsigned int GetBuildNumber() = 0;
+
+		// Opens a channel on both hands. Returns the channel id, or -1 if no channel is left.
+		virtual int OpenChannel(int priority, float maxStrength) = 0;
+
+		// Queues an event on a channel of the physical left or right hand. Thread safe.
+		virtual void Submit(int channel, bool leftHand, const HapticPulseEvent& event) = 0;
+
+		// Stops all pulses of a channel on one hand
+		virtual void Stop(int channel, bool leftHand) = 0;
+	};
+}
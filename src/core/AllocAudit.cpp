@@ -0,0 +1,127 @@
+#include "core/AllocAudit.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace AllocAudit
+{
+	namespace
+	{
+		std::atomic<Site*> g_sites{ nullptr };
+		std::atomic<Handler> g_handler{ nullptr };
+
+		thread_local Site* t_current = nullptr;
+	}
+
+	Site::Site(const char* name) :
+		name(name)
+	{
+		next = g_sites.load(std::memory_order_relaxed);
+		while (!g_sites.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed)) {}
+	}
+
+	Scope::Scope(Site& site) :
+		outer(t_current)
+	{
+		site.scopes.fetch_add(1, std::memory_order_relaxed);
+		t_current = &site;
+	}
+
+	Scope::~Scope()
+	{
+		t_current = outer;
+	}
+
+	void SetHandler(Handler handler)
+	{
+		g_handler.store(handler, std::memory_order_relaxed);
+	}
+
+	const Site* FirstSite()
+	{
+		return g_sites.load(std::memory_order_acquire);
+	}
+
+#ifdef ISPVR_ALLOC_AUDIT
+	namespace
+	{
+		void Count(std::size_t size)
+		{
+			auto* site = t_current;
+			if (!site) {
+				return;
+			}
+
+			site->allocations.fetch_add(1, std::memory_order_relaxed);
+			site->bytes.fetch_add(size, std::memory_order_relaxed);
+
+			const auto handler = g_handler.load(std::memory_order_relaxed);
+			if (handler && !site->reported.exchange(true, std::memory_order_relaxed)) {
+				t_current = nullptr;
+				handler(*site, size);
+				t_current = site;
+			}
+		}
+
+		void* AlignedAlloc(std::size_t size, std::align_val_t alignment)
+		{
+			const auto align = static_cast<std::size_t>(alignment);
+#	ifdef _WIN32
+			return _aligned_malloc(size ? size : 1, align);
+#	else
+			return std::aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align);
+#	endif
+		}
+
+		void AlignedFree(void* ptr)
+		{
+#	ifdef _WIN32
+			_aligned_free(ptr);
+#	else
+			std::free(ptr);
+#	endif
+		}
+	}
+#endif
+}
+
+#ifdef ISPVR_ALLOC_AUDIT
+// The array and nothrow forms forward to these by default
+void* operator new(std::size_t size)
+{
+	AllocAudit::Count(size);
+	if (void* ptr = std::malloc(size ? size : 1)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	AllocAudit::Count(size);
+	if (void* ptr = AllocAudit::AlignedAlloc(size, alignment)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+	AllocAudit::AlignedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+	AllocAudit::AlignedFree(ptr);
+}
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace AllocAudit
+{
+	/// <summary>
+	/// A hot path that should not allocate. Sites register themselves on first use and count the scopes entered and the heap
+	/// allocations made inside them.
+	/// </summary>
+	struct Site
+	{
+		explicit Site(const char* name);
+
+		const char* name;
+		std::atomic<std::uint64_t> scopes{ 0 };
+		std::atomic<std::uint64_t> allocations{ 0 };
+		std::atomic<std::uint64_t> bytes{ 0 };
+		std::atomic<bool> reported{ false };
+		Site* next{ nullptr };
+	};
+
+	/// <summary>
+	/// Attributes allocations of the current thread to a site until destroyed. Nested scopes count towards the innermost one.
+	/// </summary>
+	class Scope
+	{
+	public:
+		explicit Scope(Site& site);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		Site* outer;
+	};
+
+	// Called on the first allocation inside each site, with auditing suspended so the handler may allocate itself
+	using Handler = void (*)(const Site& site, std::size_t bytes);
+	void SetHandler(Handler handler);
+
+	// First registered site, follow Site::next for the rest
+	[[nodiscard]] const Site* FirstSite();
+
+	// True if this build replaces operator new and actually counts allocations
+	[[nodiscard]] constexpr bool IsEnabled()
+	{
+#ifdef ISPVR_ALLOC_AUDIT
+		return true;
+#else
+		return false;
+#endif
+	}
+}
+
+// Marks the rest of the enclosing block as a hot path that must not allocate. Compiles to nothing unless ISPVR_ALLOC_AUDIT is defined.
+#ifdef ISPVR_ALLOC_AUDIT
+#	define ISPVR_ALLOC_AUDIT_SCOPE(name)                         \
+		static ::AllocAudit::Site ispvrAllocAuditSite_{ name }; \
+		const ::AllocAudit::Scope ispvrAllocAuditScope_{ ispvrAllocAuditSite_ }
+#else
+#	define ISPVR_ALLOC_AUDIT_SCOPE(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+namespace CasterStateTracker
+{
+	// Mirrors RE::MagicCaster::State, kept free of game headers so it can be used by the portable core.
+	enum class ActualState
+	{
+		kUnknown = -1,
+		kIdle = 0,
+		kStart,
+		kCharging,
+		kHolding,
+		kReleasing,
+		kChargingUnk,
+		kCasting,
+		kUnk07,
+		kUnk08,
+		kUnk09,
+	};
+
+	/// <summary>
+	/// Returns true if the caster is busy with a spell, i.e. the attack button is supposed to be held.
+	/// </summary>
+	constexpr bool IsStateActive(ActualState state)
+	{
+		return !(state == ActualState::kIdle || state == ActualState::kReleasing);
+	}
+
+	/// <summary>
+	/// Splits charge progress (0-1) into the given number of steps. Charge listeners are only called when a hand reaches a new step.
+	/// </summary>
+	constexpr std::int64_t ChargeStepFor(float progress, std::uint32_t steps)
+	{
+		return static_cast<std::int64_t>(progress * static_cast<float>(steps));
+	}
+}
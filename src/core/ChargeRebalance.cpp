@@ -0,0 +1,27 @@
+#include "core/ChargeRebalance.h"
+
+#include <algorithm>
+
+namespace Spells
+{
+	float ChargeTimeBonusFor(const SpellInfo& spell, const RemovedAnimationTimes& times)
+	{
+		if (spell.spellType != SpellType::kSpell || spell.castingType != CastingType::kFireAndForget || !spell.learnable) {
+			return 0.0f;
+		}
+
+		const float charge = spell.delivery == Delivery::kSelf ? times.selfCharge : times.aimedCharge;
+		return std::max(charge, 0.0f) + std::max(times.release, 0.0f);
+	}
+
+	std::vector<ChargeTimeBonus> PlanChargeTimes(std::span<const SpellInfo> spells, const RemovedAnimationTimes& times)
+	{
+		std::vector<ChargeTimeBonus> plan;
+		for (const auto& spell : spells) {
+			if (const float bonus = ChargeTimeBonusFor(spell, times); bonus > 0.0f) {
+				plan.push_back({ .formID = spell.formID, .seconds = bonus });
+			}
+		}
+		return plan;
+	}
+}
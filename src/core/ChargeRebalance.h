@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "core/SpellTable.h"
+
+namespace Spells
+{
+	/// <summary>
+	/// Seconds the animations shortened by the mod used to add to a cast, see meshes/.../animations/docs.md.
+	/// </summary>
+	struct RemovedAnimationTimes
+	{
+		float aimedCharge{ 0.0f };  // mxh_precharge, charging aimed and targeted spells
+		float selfCharge{ 0.0f };  // mxh_selfprecharge, charging self targeted spells
+		float release{ 0.0f };  // mxh_release, delay between letting go and the spell firing
+	};
+
+	struct ChargeTimeBonus
+	{
+		std::uint32_t formID{ 0 };
+		float seconds{ 0.0f };
+	};
+
+	// Charge time a spell should gain to make up for the shortened animations. Only hand cast fire and forget spells the player can
+	// learn use those animations, powers, shouts, diseases and NPC only spells are left alone.
+	[[nodiscard]] float ChargeTimeBonusFor(const SpellInfo& spell, const RemovedAnimationTimes& times);
+
+	/// <summary>
+	/// Works out the charge time bonus of every affected spell. Spells without a bonus are left out. The bonus is added on top of
+	/// the spell's current charge time when applied, so planning again after undoing never compounds.
+	/// </summary>
+	[[nodiscard]] std::vector<ChargeTimeBonus> PlanChargeTimes(std::span<const SpellInfo> spells, const RemovedAnimationTimes& times);
+}
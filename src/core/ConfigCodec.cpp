@@ -0,0 +1,155 @@
+#include "core/ConfigCodec.h"
+
+#include <cctype>
+#include <iomanip>
+#include <locale>
+#include <sstream>
+
+namespace
+{
+	using namespace std::literals;
+
+	std::string_view TrimView(std::string_view input)
+	{
+		const auto first = input.find_first_not_of(" \t\r\n"sv);
+		if (first == std::string_view::npos) {
+			return {};
+		}
+		const auto last = input.find_last_not_of(" \t\r\n"sv);
+		return input.substr(first, last - first + 1);
+	}
+
+	std::string TrimCopy(std::string_view input)
+	{
+		const auto trimmed = TrimView(input);
+		return { trimmed.begin(), trimmed.end() };
+	}
+
+	std::string ToLower(std::string_view input)
+	{
+		std::string result;
+		result.reserve(input.size());
+		for (const auto ch : input) {
+			result.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+		}
+		return result;
+	}
+}
+
+namespace Config::Codec
+{
+	Type ResolveValueType(const Value& value)
+	{
+		return std::visit(
+			[](auto&& val) -> Type {
+				using T = std::decay_t<decltype(val)>;
+				if constexpr (std::is_same_v<T, bool>) {
+					return Type::kBool;
+				} else if constexpr (std::is_same_v<T, std::int64_t>) {
+					return Type::kInteger;
+				} else if constexpr (std::is_same_v<T, double>) {
+					return Type::kFloat;
+				} else if constexpr (std::is_same_v<T, std::string>) {
+					return Type::kString;
+				} else {
+					static_assert(!sizeof(T), "Unsupported config value type");
+				}
+			},
+			value
+		);
+	}
+
+	std::string SerializeValue(const Value& value, Type type)
+	{
+		std::ostringstream stream;
+		stream.imbue(std::locale::classic());
+
+		switch (type) {
+		case Type::kBool:
+			stream << (std::get<bool>(value) ? "true" : "false");
+			break;
+		case Type::kInteger:
+			stream << std::get<std::int64_t>(value);
+			break;
+		case Type::kFloat:
+			stream << std::setprecision(6) << std::fixed << std::get<double>(value);
+			break;
+		case Type::kString:
+			{
+				const auto& str = std::get<std::string>(value);
+				if (str.find_first_of(" \t") != std::string::npos) {
+					stream << '"' << str << '"';
+				} else {
+					stream << str;
+				}
+				break;
+			}
+		}
+
+		return stream.str();
+	}
+
+	std::optional<Value> DeserializeValue(Type type, std::string_view raw)
+	{
+		switch (type) {
+		case Type::kBool:
+			{
+				const auto lower = ToLower(raw);
+				if (lower == "true" || lower == "1" || lower == "yes" || lower == "on") {
+					return Value{ true };
+				}
+				if (lower == "false" || lower == "0" || lower == "no" || lower == "off") {
+					return Value{ false };
+				}
+				return std::nullopt;
+			}
+		case Type::kInteger:
+			{
+				try {
+					const auto value = std::stoll(std::string(raw));
+					return Value{ static_cast<std::int64_t>(value) };
+				} catch (...) {
+					return std::nullopt;
+				}
+			}
+		case Type::kFloat:
+			{
+				try {
+					const auto value = std::stod(std::string(raw));
+					return Value{ static_cast<double>(value) };
+				} catch (...) {
+					return std::nullopt;
+				}
+			}
+		case Type::kString:
+			{
+				auto str = TrimCopy(raw);
+				if (!str.empty() && str.front() == '"' && str.back() == '"' && str.size() >= 2) {
+					str = str.substr(1, str.size() - 2);
+				}
+				if (!str.empty()) {
+					return Value{ str };
+				}
+				return std::nullopt;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	std::string_view TypeToString(Type type)
+	{
+		switch (type) {
+		case Type::kBool:
+			return "bool"sv;
+		case Type::kInteger:
+			return "integer"sv;
+		case Type::kFloat:
+			return "float"sv;
+		case Type::kString:
+			return "string"sv;
+		default:
+			return "unknown"sv;
+		}
+	}
+}
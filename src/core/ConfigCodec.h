@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+namespace Config
+{
+	enum class Type
+	{
+		kBool,
+		kInteger,
+		kFloat,
+		kString
+	};
+
+	enum class ChangeSource
+	{
+		kFromIni,
+		kFromMCM,
+		kFromCode
+	};
+
+	using Value = std::variant<bool, std::int64_t, double, std::string>;
+
+	/// <summary>
+	/// Conversion between config values and their INI representation.
+	/// </summary>
+	namespace Codec
+	{
+		[[nodiscard]] Type ResolveValueType(const Value& value);
+		[[nodiscard]] std::string SerializeValue(const Value& value, Type type);
+		[[nodiscard]] std::optional<Value> DeserializeValue(Type type, std::string_view raw);
+		[[nodiscard]] std::string_view TypeToString(Type type);
+	}
+}
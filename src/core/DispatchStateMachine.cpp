@@ -0,0 +1,121 @@
+#include "core/DispatchStateMachine.h"
+
+#include <algorithm>
+
+#include "core/Metrics.h"
+
+namespace InputDispatcher
+{
+	DispatchStateMachine::DispatchStateMachine(Utils::Clock::time_point now) :
+		currentInputStartTime(now)
+	{}
+
+	bool DispatchStateMachine::Declare(bool casterActive)
+	{
+		const bool kOldCasterActive = casterDeclaredActive.exchange(casterActive, std::memory_order_relaxed);
+		if (kOldCasterActive != casterActive) {
+			casterDeclarationChanged = true;
+			return true;
+		}
+		return false;
+	}
+
+	void DispatchStateMachine::SuppressUntilCasterInactive()
+	{
+		suppressUntilCasterInactive.store(true);
+	}
+
+	DispatchStateMachine::Decision DispatchStateMachine::Step(CasterStateTracker::ActualState casterState, Utils::Clock::time_point now)
+	{
+		const bool kCasterDesiredActive = casterDeclaredActive.load(std::memory_order_relaxed);
+		const bool kCasterActive = CasterStateTracker::IsStateActive(casterState);
+
+		if (suppressUntilCasterInactive.load(std::memory_order_relaxed)) {
+			if (kCasterDesiredActive) {
+				Metrics::Increment(Metrics::Counter::kSuppressedInputs);
+				return {};
+			}
+			suppressUntilCasterInactive.store(false, std::memory_order_relaxed);
+		}
+
+		if (kCasterActive == kCasterDesiredActive && !casterDeclarationChanged.load(std::memory_order_relaxed)) {
+			consecutiveRetries = 0;
+			watchdogTripped = false;
+			return {};
+		}
+
+		Decision decision{
+			.sendInput = true,
+			.pressed = kCasterDesiredActive,
+			.nextInterval = kRetryInterval,
+		};
+
+		if (casterDeclarationChanged.exchange(false, std::memory_order_relaxed)) {
+			currentInputStartTime = now;
+			consecutiveRetries = 0;
+			watchdogTripped = false;
+			return decision;
+		}
+
+		// Once given up, only a caster state change (e.g. the stagger ended) earns another round of retries
+		if (watchdogTripped) {
+			if (casterState == trippedCasterState) {
+				return {};
+			}
+			watchdogTripped = false;
+			consecutiveRetries = 0;
+			currentInputStartTime = now;
+		}
+
+		if (consecutiveRetries >= kMaxRetries) {
+			Metrics::Increment(Metrics::Counter::kWatchdogTrips);
+			watchdogTripped = true;
+			trippedCasterState = casterState;
+			return { .retries = consecutiveRetries, .gaveUp = true };
+		}
+
+		// The caster didn't follow the last input yet, this is a re-press
+		Metrics::Increment(Metrics::Counter::kRepresses);
+		decision.retries = ++consecutiveRetries;
+		decision.nextInterval = RetryIntervalFor(decision.retries);
+
+		const auto elapsed = now - currentInputStartTime;
+		if (elapsed <= kGracePeriod) {
+			decision.heldSecOverride = std::chrono::duration<float>(elapsed).count();
+			return decision;
+		}
+
+		currentInputStartTime = now;
+		return decision;
+	}
+
+	std::chrono::milliseconds DispatchStateMachine::RetryIntervalFor(std::uint32_t retries)
+	{
+		if (retries <= kBackoffAfterRetries) {
+			return kRetryInterval;
+		}
+
+		const auto doublings = std::min<std::uint32_t>(retries - kBackoffAfterRetries, 16);
+		return std::min(kRetryInterval * (1 << doublings), kMaxRetryInterval);
+	}
+
+	InjectionGate::Admission InjectionGate::Admit(bool pressed)
+	{
+		const auto current = pending.load(std::memory_order_acquire);
+		if (current > 0 && lastQueuedPressed == pressed) {
+			return Admission::kMerge;
+		}
+		if (current >= kMaxPending) {
+			return Admission::kDrop;
+		}
+
+		lastQueuedPressed = pressed;
+		pending.fetch_add(1, std::memory_order_acq_rel);
+		return Admission::kQueue;
+	}
+
+	void InjectionGate::OnRun()
+	{
+		pending.fetch_sub(1, std::memory_order_acq_rel);
+	}
+}
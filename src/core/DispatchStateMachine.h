@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "core/CasterState.h"
+#include "utils/Clock.h"
+
+namespace InputDispatcher
+{
+	/// <summary>
+	/// Decides which attack button events a hand needs so that its caster ends up in the declared state. Game independent, the
+	/// HandInputDispatcher feeds it the current caster state and sends whatever it asks for.
+	/// </summary>
+	class DispatchStateMachine
+	{
+	public:
+		struct Decision
+		{
+			bool sendInput = false;
+			bool pressed = false;
+			float heldSecOverride = 0.0f;  // 0 lets the sender pick the default hold duration.
+			std::chrono::milliseconds nextInterval{ 0 };  // When to step again, 0 to wait for the next notification.
+			std::uint32_t retries = 0;  // Re-presses since the declaration changed without the caster following
+			bool gaveUp = false;  // Set once when the watchdog stops retrying
+		};
+
+		explicit DispatchStateMachine(Utils::Clock::time_point now);
+
+		/// <summary>
+		/// Declares whether the caster should be active. Returns true if the declaration changed.
+		/// </summary>
+		bool Declare(bool casterActive);
+
+		// Suppresses all input until the caster has been declared inactive at least once.
+		void SuppressUntilCasterInactive();
+
+		Decision Step(CasterStateTracker::ActualState casterState, Utils::Clock::time_point now);
+
+		/// <summary>
+		/// How long to wait for the caster state to change after sending an input
+		/// </summary>
+		constexpr static std::chrono::milliseconds kGracePeriod = std::chrono::milliseconds(200);
+
+		// Inputs typically take 10ms to result in a changed caster state so 20ms should be pretty efficient in case a repress is needed.
+		constexpr static std::chrono::milliseconds kRetryInterval = std::chrono::milliseconds(20);
+
+		// Watchdog: after the grace period of full rate retries the interval doubles with every retry up to kMaxRetryInterval. After
+		// kMaxRetries the game is assumed to ignore the input (stagger, scripted scene) and retrying stops until the caster state or
+		// the declaration changes. That covers a few seconds of ignored input.
+		constexpr static std::uint32_t kBackoffAfterRetries = 10;
+		constexpr static std::chrono::milliseconds kMaxRetryInterval = std::chrono::milliseconds(1000);
+		constexpr static std::uint32_t kMaxRetries = 20;
+
+		[[nodiscard]] static std::chrono::milliseconds RetryIntervalFor(std::uint32_t retries);
+
+	private:
+		/// <summary>
+		/// The caster being active means that the attack button is held to ensure the casters state is appropriate (anything other than kIdle kReleasing).
+		/// This way inputs can be retriggered if the game ignored them for some reason until the caster has the desired state.
+		/// </summary>
+		std::atomic<bool> casterDeclaredActive{ false };
+
+		// Set to true whenever the caster state declaration changes, set to false after the change was processed.
+		std::atomic<bool> casterDeclarationChanged{ false };
+
+		std::atomic<bool> suppressUntilCasterInactive{ false };
+
+		// Time point at which input changed last
+		Utils::Clock::time_point currentInputStartTime;
+
+		std::uint32_t consecutiveRetries{ 0 };
+
+		// Set while the watchdog has given up, together with the caster state it gave up in
+		bool watchdogTripped{ false };
+		CasterStateTracker::ActualState trippedCasterState{ CasterStateTracker::ActualState::kUnknown };
+	};
+
+	/// <summary>
+	/// Back pressure for attack events queued to the UI thread. If earlier events have not run yet (the UI thread is stalled),
+	/// an event that repeats the last queued one is merged into it and nothing beyond kMaxPending is queued.
+	/// Admit must only be called from one thread, OnRun from the thread running the events.
+	/// </summary>
+	class InjectionGate
+	{
+	public:
+		enum class Admission
+		{
+			kQueue,
+			kMerge,  // An identical event is still pending
+			kDrop  // Too many events are pending
+		};
+
+		constexpr static std::uint32_t kMaxPending = 4;
+
+		Admission Admit(bool pressed);
+		void OnRun();
+
+		[[nodiscard]] std::uint32_t Pending() const { return pending.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<std::uint32_t> pending{ 0 };
+		bool lastQueuedPressed{ false };
+	};
+}
@@ -0,0 +1,104 @@
+#include "core/FlightRecorder.h"
+
+#include <chrono>
+#include <fstream>
+
+namespace Recorder
+{
+	namespace
+	{
+		// Payload layout: bits 0-7 type, 8-15 a, 16-23 b, 32-63 value
+		std::uint64_t Pack(RecordType type, std::uint8_t a, std::uint8_t b, std::uint32_t value)
+		{
+			return static_cast<std::uint64_t>(type) |
+			       (static_cast<std::uint64_t>(a) << 8) |
+			       (static_cast<std::uint64_t>(b) << 16) |
+			       (static_cast<std::uint64_t>(value) << 32);
+		}
+
+		FlightRecorder g_leftRecorder(0);
+		FlightRecorder g_rightRecorder(1);
+	}
+
+	void FlightRecorder::Record(RecordType type, std::uint8_t a, std::uint8_t b, std::uint32_t value)
+	{
+		const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(clock.Now().time_since_epoch()).count();
+		auto& slot = slots[head.fetch_add(1, std::memory_order_relaxed) & (kCapacity - 1)];
+		slot.payload.store(Pack(type, a, b, value), std::memory_order_relaxed);
+		slot.timestamp.store(static_cast<std::uint64_t>(now), std::memory_order_release);
+	}
+
+	std::vector<Record> FlightRecorder::Snapshot() const
+	{
+		const auto end = head.load(std::memory_order_acquire);
+		const auto begin = end > kCapacity ? end - kCapacity : 0;
+
+		std::vector<Recorder::Record> records;
+		records.reserve(static_cast<std::size_t>(end - begin));
+		for (auto i = begin; i < end; ++i) {
+			const auto& slot = slots[i & (kCapacity - 1)];
+			const auto timestamp = slot.timestamp.load(std::memory_order_acquire);
+			const auto payload = slot.payload.load(std::memory_order_relaxed);
+			if (timestamp == 0) {
+				continue;  // Claimed but not written yet
+			}
+
+			records.push_back({
+				.timestampNanoseconds = timestamp,
+				.type = static_cast<RecordType>(payload & 0xFF),
+				.hand = hand,
+				.a = static_cast<std::uint8_t>((payload >> 8) & 0xFF),
+				.b = static_cast<std::uint8_t>((payload >> 16) & 0xFF),
+				.value = static_cast<std::uint32_t>(payload >> 32),
+			});
+		}
+		return records;
+	}
+
+	bool FlightRecorder::Dump(const std::filesystem::path& path, AnomalyKind anomaly) const
+	{
+		const auto records = Snapshot();
+
+		DumpHeader header{};
+		header.recordCount = static_cast<std::uint32_t>(records.size());
+		header.hand = hand;
+		header.anomaly = static_cast<std::uint8_t>(anomaly);
+		header.dumpedAtNanoseconds = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock.Now().time_since_epoch()).count());
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Recorder::Record)));
+		return static_cast<bool>(file);
+	}
+
+	std::optional<LoadedDump> LoadDump(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			return std::nullopt;
+		}
+
+		LoadedDump dump{};
+		if (!file.read(reinterpret_cast<char*>(&dump.header), sizeof(dump.header))
+			|| dump.header.magic != DumpHeader::kMagic
+			|| dump.header.version != DumpHeader::kVersion
+			|| dump.header.recordSize != sizeof(Recorder::Record)
+			|| dump.header.recordCount > FlightRecorder::kCapacity) {
+			return std::nullopt;
+		}
+
+		dump.records.resize(dump.header.recordCount);
+		if (!file.read(reinterpret_cast<char*>(dump.records.data()), static_cast<std::streamsize>(dump.records.size() * sizeof(Recorder::Record)))) {
+			return std::nullopt;
+		}
+		return dump;
+	}
+
+	FlightRecorder& ForHand(bool physicalLeft)
+	{
+		return physicalLeft ? g_leftRecorder : g_rightRecorder;
+	}
+}
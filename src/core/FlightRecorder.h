@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "utils/Clock.h"
+
+namespace Recorder
+{
+	enum class RecordType : std::uint8_t
+	{
+		kGrip,         // a = casting button pressed, b = forced refresh
+		kDeclared,     // a = caster declared active
+		kInjected,     // a = pressed, b = main hand, value = held duration in microseconds
+		kCasterState,  // a = previous state + 1, b = current state + 1, value = hand mask
+		kDecision,     // a = pressed, b = caster state + 1, value = consecutive retries
+		kAnomaly,      // a = anomaly kind, value = detail
+		kSkipped       // a = pressed, b = InjectionGate::Admission, value = pending events
+	};
+
+	enum class AnomalyKind : std::uint8_t
+	{
+		kNoConvergence  // The dispatcher kept re-pressing without the caster reaching the declared state, the watchdog gave up
+	};
+
+	/// <summary>
+	/// One recorded entry, 16 bytes. The layout is part of the dump format.
+	/// </summary>
+	struct Record
+	{
+		std::uint64_t timestampNanoseconds;  // Steady clock
+		RecordType type;
+		std::uint8_t hand;  // 0 = physical left, 1 = physical right
+		std::uint8_t a;
+		std::uint8_t b;
+		std::uint32_t value;
+	};
+	static_assert(sizeof(Record) == 16);
+
+	// Dump file: DumpHeader followed by recordCount records, oldest first, little endian.
+	struct DumpHeader
+	{
+		std::uint32_t magic{ kMagic };
+		std::uint16_t version{ kVersion };
+		std::uint16_t recordSize{ sizeof(Record) };
+		std::uint32_t recordCount{ 0 };
+		std::uint8_t hand{ 0 };
+		std::uint8_t anomaly{ 0 };
+		std::uint16_t reserved{ 0 };
+		std::uint64_t dumpedAtNanoseconds{ 0 };
+
+		constexpr static std::uint32_t kMagic = 0x52465049;  // "IPFR"
+		constexpr static std::uint16_t kVersion = 1;
+	};
+	static_assert(sizeof(DumpHeader) == 24);
+
+	/// <summary>
+	/// Fixed ring of the most recent records of one hand. Recording is wait-free and never allocates: a slot is claimed with a
+	/// single fetch_add and written as two relaxed words. A snapshot taken while a slot is being written may contain one torn record.
+	/// </summary>
+	class FlightRecorder
+	{
+	public:
+		constexpr static std::size_t kCapacity = 1024;  // Several seconds of activity even while the dispatcher retries every 20ms
+
+		explicit FlightRecorder(std::uint8_t hand, Utils::Clock& clock = Utils::Clock::Steady()) :
+			hand(hand), clock(clock) {}
+
+		void Record(RecordType type, std::uint8_t a = 0, std::uint8_t b = 0, std::uint32_t value = 0);
+
+		/// <summary>
+		/// Copies the recorded entries, oldest first.
+		/// </summary>
+		[[nodiscard]] std::vector<Recorder::Record> Snapshot() const;
+
+		/// <summary>
+		/// Writes a snapshot to the given file. Returns false if the file could not be written.
+		/// </summary>
+		bool Dump(const std::filesystem::path& path, AnomalyKind anomaly) const;
+
+	private:
+		static_assert((kCapacity & (kCapacity - 1)) == 0, "Capacity must be a power of two");
+
+		struct Slot
+		{
+			std::atomic<std::uint64_t> timestamp{ 0 };
+			std::atomic<std::uint64_t> payload{ 0 };
+		};
+
+		std::uint8_t hand;
+		Utils::Clock& clock;
+		std::atomic<std::uint64_t> head{ 0 };
+		std::array<Slot, kCapacity> slots;
+	};
+
+	struct LoadedDump
+	{
+		DumpHeader header;
+		std::vector<Record> records;
+	};
+
+	/// <summary>
+	/// Reads a dump written by FlightRecorder::Dump. Returns nothing if the file can't be read or is not a dump of this version.
+	/// </summary>
+	[[nodiscard]] std::optional<LoadedDump> LoadDump(const std::filesystem::path& path);
+
+	/// <summary>
+	/// The recorder of a physical hand.
+	/// </summary>
+	FlightRecorder& ForHand(bool physicalLeft);
+}
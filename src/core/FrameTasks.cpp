@@ -0,0 +1,80 @@
+#include "core/FrameTasks.h"
+
+namespace Tasks
+{
+	Scheduler::Scheduler(Utils::Clock& clock) :
+		clock(clock)
+	{}
+
+	Scheduler::~Scheduler()
+	{
+		Destroy(spawned);
+		Destroy(waiting);
+	}
+
+	void Scheduler::Spawn(Task task)
+	{
+		auto& promise = std::exchange(task.handle, {}).promise();
+		promise.scheduler = this;
+
+		std::scoped_lock lock(spawnMutex);
+		promise.next = spawned;
+		spawned = &promise;
+		pending.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	std::size_t Scheduler::Tick()
+	{
+		// Spawned tasks run their first step on this tick
+		{
+			std::scoped_lock lock(spawnMutex);
+			while (spawned) {
+				auto* promise = std::exchange(spawned, spawned->next);
+				promise->next = waiting;
+				waiting = promise;
+			}
+		}
+
+		const auto now = clock.Now();
+		Promise* stillWaiting = nullptr;
+		std::size_t remaining = 0;
+
+		while (waiting) {
+			auto* promise = std::exchange(waiting, waiting->next);
+
+			if (IsReady(*promise, now)) {
+				const auto handle = Task::Handle::from_promise(*promise);
+				handle.resume();
+				if (handle.done()) {
+					handle.destroy();
+					pending.fetch_sub(1, std::memory_order_relaxed);
+					continue;
+				}
+			}
+
+			// Tasks that suspended again are not resumed before the next tick
+			promise->next = stillWaiting;
+			stillWaiting = promise;
+			++remaining;
+		}
+
+		waiting = stillWaiting;
+		return remaining;
+	}
+
+	bool Scheduler::IsReady(const Promise& promise, Utils::Clock::time_point now)
+	{
+		if (promise.condition && promise.condition(promise.conditionContext)) {
+			return true;
+		}
+		return now >= promise.deadline;
+	}
+
+	void Scheduler::Destroy(Promise* list)
+	{
+		while (list) {
+			auto* promise = std::exchange(list, list->next);
+			Task::Handle::from_promise(*promise).destroy();
+		}
+	}
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <utility>
+
+#include "utils/Clock.h"
+
+namespace Tasks
+{
+	class Scheduler;
+
+	/// <summary>
+	/// Fire-and-forget coroutine for multi-step game interactions. Once spawned it is stepped by a Scheduler, which resumes it
+	/// on the first tick where the awaited condition holds. The frame is allocated once on creation, suspending and resuming don't allocate.
+	/// </summary>
+	class Task
+	{
+	public:
+		struct promise_type
+		{
+			Task get_return_object() { return Task{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+			std::suspend_always initial_suspend() noexcept { return {}; }
+			std::suspend_always final_suspend() noexcept { return {}; }
+			void return_void() noexcept {}
+			void unhandled_exception() noexcept { std::terminate(); }
+
+			// Wait condition of the awaitable the task is suspended on. Ready once condition(conditionContext) holds or the deadline passed.
+			Utils::Clock::time_point deadline{ Utils::Clock::time_point::min() };
+			bool (*condition)(const void*) = nullptr;
+			const void* conditionContext = nullptr;
+
+			Scheduler* scheduler = nullptr;
+			promise_type* next = nullptr;  // Intrusive scheduler queue
+		};
+
+		using Handle = std::coroutine_handle<promise_type>;
+
+		Task(Task&& other) noexcept :
+			handle(std::exchange(other.handle, {}))
+		{}
+		Task& operator=(Task&&) = delete;
+
+		~Task()
+		{
+			if (handle) {
+				handle.destroy();
+			}
+		}
+
+	private:
+		friend class Scheduler;
+
+		explicit Task(Handle handle) :
+			handle(handle)
+		{}
+
+		Handle handle;
+	};
+
+	/// <summary>
+	/// Steps spawned tasks. Spawn() may be called from any thread, Tick() must always be called from the same thread.
+	/// </summary>
+	class Scheduler
+	{
+	public:
+		explicit Scheduler(Utils::Clock& clock = Utils::Clock::Steady());
+		~Scheduler();
+
+		Scheduler(const Scheduler&) = delete;
+		Scheduler& operator=(const Scheduler&) = delete;
+
+		void Spawn(Task task);
+
+		/// <summary>
+		/// Resumes every task whose wait condition holds. Returns the number of tasks that are still pending.
+		/// </summary>
+		std::size_t Tick();
+
+		[[nodiscard]] bool HasPending() const { return pending.load(std::memory_order_relaxed) > 0; }
+		[[nodiscard]] Utils::Clock& GetClock() const { return clock; }
+
+	private:
+		using Promise = Task::promise_type;
+
+		static bool IsReady(const Promise& promise, Utils::Clock::time_point now);
+		static void Destroy(Promise* list);
+
+		Utils::Clock& clock;
+
+		std::mutex spawnMutex;
+		Promise* spawned = nullptr;  // Tasks spawned since the last tick
+		Promise* waiting = nullptr;  // Only touched by the ticking thread
+		std::atomic<std::size_t> pending{ 0 };
+	};
+
+	/// <summary>
+	/// Suspends until the next scheduler tick, optionally for at least the given delay.
+	/// </summary>
+	struct DelayAwaiter
+	{
+		Utils::Clock::duration delay{ 0 };
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(Task::Handle handle) const noexcept
+		{
+			auto& promise = handle.promise();
+			promise.condition = nullptr;
+			promise.deadline = delay.count() > 0 ? promise.scheduler->GetClock().Now() + delay : Utils::Clock::time_point::min();
+		}
+		void await_resume() const noexcept {}
+	};
+
+	/// <summary>
+	/// Suspends until the predicate holds (checked once per tick) or the timeout expired. Returns whether the predicate held.
+	/// </summary>
+	template <class Predicate>
+	struct ConditionAwaiter
+	{
+		Predicate predicate;
+		Utils::Clock::duration timeout;
+
+		bool await_ready() const { return predicate(); }
+		void await_suspend(Task::Handle handle) const noexcept
+		{
+			auto& promise = handle.promise();
+			// The awaiter lives in the coroutine frame while the task is suspended, so it can be its own context
+			promise.condition = [](const void* self) { return static_cast<const ConditionAwaiter*>(self)->predicate(); };
+			promise.conditionContext = this;
+			promise.deadline = timeout == Utils::Clock::duration::max() ? Utils::Clock::time_point::max() : promise.scheduler->GetClock().Now() + timeout;
+		}
+		bool await_resume() const { return predicate(); }
+	};
+
+	inline DelayAwaiter NextFrame() { return {}; }
+
+	template <class Rep, class Period>
+	DelayAwaiter Delay(std::chrono::duration<Rep, Period> delay)
+	{
+		return { std::chrono::duration_cast<Utils::Clock::duration>(delay) };
+	}
+
+	template <class Predicate>
+	ConditionAwaiter<Predicate> WaitUntil(Predicate predicate, Utils::Clock::duration timeout = Utils::Clock::duration::max())
+	{
+		return { std::move(predicate), timeout };
+	}
+}
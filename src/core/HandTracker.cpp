@@ -0,0 +1,31 @@
+#include "core/HandTracker.h"
+
+namespace CasterStateTracker
+{
+	HandTracker::Update HandTracker::OnCasterUpdate(bool leftHandCaster, bool physicalLeft, ActualState state, bool dualCasting)
+	{
+		Update update{ .currentState = state };
+		if (dualCasting && !leftHandCaster) {
+			return update;
+		}
+
+		for (const bool hand : { true, false }) {
+			if (!dualCasting && hand != physicalLeft) {
+				continue;
+			}
+
+			const auto mask = HandMaskFor(hand);
+			const ActualState previousState = (hand ? leftHandState : rightHandState).exchange(state, std::memory_order_relaxed);
+			if (state == ActualState::kCharging || previousState == ActualState::kCharging) {
+				update.chargeMask |= mask;
+			}
+			if (previousState != state) {
+				if (update.changedMask == 0 || hand == physicalLeft) {
+					update.previousState = previousState;
+				}
+				update.changedMask |= mask;
+			}
+		}
+		return update;
+	}
+}
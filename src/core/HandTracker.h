@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "core/CasterState.h"
+
+namespace HandOrientation
+{
+	// Rules behind the orientation table, kept free of game headers. The main hand casts from the right-hand casting source,
+	// left-handed mode swaps which physical hand that is.
+	constexpr bool IsMainHand(bool physicalLeft, bool leftHandedMode) { return physicalLeft == leftHandedMode; }
+	constexpr bool IsPhysicalLeft(bool isMainHand, bool leftHandedMode) { return isMainHand == leftHandedMode; }
+}
+
+namespace CasterStateTracker
+{
+	// Physical hands an event applies to
+	constexpr std::uint8_t kLeftHandMask = 1 << 0;
+	constexpr std::uint8_t kRightHandMask = 1 << 1;
+	constexpr std::uint8_t kBothHandsMask = kLeftHandMask | kRightHandMask;
+
+	constexpr std::uint8_t HandMaskFor(bool physicalLeft) { return physicalLeft ? kLeftHandMask : kRightHandMask; }
+
+	/// <summary>
+	/// Keeps the last state of both physical hands and works out which of them a caster update changed. While dual casting the
+	/// left-hand caster drives both hands and updates of the right-hand caster are ignored, so the hands can't diverge and a
+	/// change is reported once for both of them.
+	/// </summary>
+	class HandTracker
+	{
+	public:
+		struct Update
+		{
+			std::uint8_t changedMask{ 0 };  // Hands whose state changed, one event covers all of them
+			std::uint8_t chargeMask{ 0 };  // Hands that are charging or just stopped charging
+			ActualState previousState{ ActualState::kUnknown };  // Of the caster's own hand if it changed, otherwise of the other one
+			ActualState currentState{ ActualState::kUnknown };
+		};
+
+		HandTracker(std::atomic<ActualState>& leftHandState, std::atomic<ActualState>& rightHandState) :
+			leftHandState(leftHandState),
+			rightHandState(rightHandState)
+		{}
+
+		/// <summary>
+		/// Records the state of a hand caster. leftHandCaster is true for the caster of the left-hand casting source, physicalLeft
+		/// for the caster held in the physical left hand. Must always be called from the same thread.
+		/// </summary>
+		Update OnCasterUpdate(bool leftHandCaster, bool physicalLeft, ActualState state, bool dualCasting);
+
+	private:
+		std::atomic<ActualState>& leftHandState;
+		std::atomic<ActualState>& rightHandState;
+	};
+}
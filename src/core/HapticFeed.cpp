@@ -0,0 +1,59 @@
+#include "core/HapticFeed.h"
+
+namespace Haptics
+{
+	namespace
+	{
+		// Layout: bit 0 pending, bit 1 state set, bit 2 charge set, bits 8-15 previous state, 16-23 current state, 24-31 charge
+		// step. States are stored +1 to fit kUnknown.
+		constexpr std::uint32_t kPending = 1 << 0;
+		constexpr std::uint32_t kHasState = 1 << 1;
+		constexpr std::uint32_t kHasCharge = 1 << 2;
+		constexpr std::uint32_t kStateBits = kHasState | 0xFFFF00;
+
+		using ActualState = FeedMailbox::ActualState;
+
+		std::uint32_t PackState(ActualState state) { return static_cast<std::uint8_t>(static_cast<int>(state) + 1); }
+		ActualState UnpackPrevious(std::uint32_t packed) { return static_cast<ActualState>(static_cast<int>((packed >> 8) & 0xFF) - 1); }
+		ActualState UnpackCurrent(std::uint32_t packed) { return static_cast<ActualState>(static_cast<int>((packed >> 16) & 0xFF) - 1); }
+
+		template <class Update>
+		bool Post(std::atomic<std::uint32_t>& word, Update update)
+		{
+			auto current = word.load(std::memory_order_acquire);
+			while (!word.compare_exchange_weak(current, update(current), std::memory_order_acq_rel, std::memory_order_acquire)) {}
+			return !(current & kPending);
+		}
+	}
+
+	bool FeedMailbox::PostState(bool physicalLeft, ActualState previousState, ActualState currentState)
+	{
+		return Post(mailbox[physicalLeft ? 0 : 1], [&](std::uint32_t current) {
+			const auto previous = (current & kHasState) ? UnpackPrevious(current) : previousState;
+			return kPending | kHasState | (PackState(previous) << 8) | (PackState(currentState) << 16);
+		});
+	}
+
+	bool FeedMailbox::PostCharge(bool physicalLeft, std::uint8_t step)
+	{
+		return Post(mailbox[physicalLeft ? 0 : 1], [&](std::uint32_t current) {
+			return (current & kStateBits) | kPending | kHasCharge | (static_cast<std::uint32_t>(step) << 24);
+		});
+	}
+
+	std::optional<FeedMailbox::Update> FeedMailbox::Take(bool physicalLeft)
+	{
+		const auto packed = mailbox[physicalLeft ? 0 : 1].exchange(0, std::memory_order_acquire);
+		if (!(packed & kPending)) {
+			return std::nullopt;
+		}
+
+		return Update{
+			.hasState = (packed & kHasState) != 0,
+			.previousState = UnpackPrevious(packed),
+			.currentState = UnpackCurrent(packed),
+			.hasCharge = (packed & kHasCharge) != 0,
+			.chargeStep = static_cast<std::uint8_t>(packed >> 24),
+		};
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+#include "core/CasterState.h"
+
+namespace Haptics
+{
+	/// <summary>
+	/// Hands caster state and charge steps of both hands from the main thread to a haptics worker. Every physical hand has a single
+	/// mailbox word, so posting never blocks or allocates and the two streams can't overtake each other. A backlog collapses into
+	/// the latest state (with the first previous state) followed by the latest charge step.
+	/// </summary>
+	class FeedMailbox
+	{
+	public:
+		using ActualState = CasterStateTracker::ActualState;
+
+		struct Update
+		{
+			bool hasState{ false };
+			ActualState previousState{ ActualState::kUnknown };
+			ActualState currentState{ ActualState::kUnknown };
+			bool hasCharge{ false };
+			std::uint8_t chargeStep{ 0 };
+		};
+
+		// Both return true if the hand had nothing pending before, the consumer has to be woken then
+		bool PostState(bool physicalLeft, ActualState previousState, ActualState currentState);
+		bool PostCharge(bool physicalLeft, std::uint8_t step);
+
+		/// <summary>
+		/// Takes the pending update of a hand. A new state restarts the charge ramp, so charge steps posted before it are dropped.
+		/// </summary>
+		std::optional<Update> Take(bool physicalLeft);
+
+	private:
+		std::array<std::atomic<std::uint32_t>, 2> mailbox{};  // Indexed by physical hand, left first
+	};
+}
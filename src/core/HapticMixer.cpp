@@ -0,0 +1,88 @@
+#include "core/HapticMixer.h"
+
+#include <algorithm>
+
+namespace Haptics
+{
+	int HapticMixer::AddChannel(int priority, float maxStrength)
+	{
+		std::scoped_lock lock(channelsMutex);
+		const auto index = channelCount.load(std::memory_order_relaxed);
+		if (index >= kMaxChannels) {
+			return -1;
+		}
+
+		auto& channel = channels[index];
+		channel.priority = priority;
+		channel.maxStrength = std::clamp(maxStrength, 0.0f, 1.0f);
+		channelCount.store(index + 1, std::memory_order_release);
+		return static_cast<int>(index);
+	}
+
+	bool HapticMixer::IsValidChannel(int channel) const
+	{
+		return channel >= 0 && static_cast<std::size_t>(channel) < channelCount.load(std::memory_order_acquire);
+	}
+
+	bool HapticMixer::Schedule(int channel, const HapticEvent& event)
+	{
+		if (!IsValidChannel(channel)) {
+			return false;
+		}
+
+		auto& target = channels[channel];
+		target.scheduler.Schedule(event);
+
+		// Stepping a channel in the middle of its interval would pulse early, so only interrupts and idle channels are woken
+		if (event.interruptPulse || !target.active.load(std::memory_order_relaxed)) {
+			target.wake.store(true, std::memory_order_release);
+			return true;
+		}
+		return false;
+	}
+
+	HapticScheduler::Tick HapticMixer::Advance(std::chrono::steady_clock::time_point now)
+	{
+		std::array<float, kMaxChannels> pulses{};
+		bool anyActive = false;
+		int topPriority = 0;
+		auto nextDue = std::chrono::steady_clock::time_point::max();
+
+		const auto count = channelCount.load(std::memory_order_acquire);
+		for (std::size_t i = 0; i < count; ++i) {
+			auto& channel = channels[i];
+
+			const bool woken = channel.wake.exchange(false, std::memory_order_acquire);
+			bool active = channel.active.load(std::memory_order_relaxed);
+			if (woken || (active && channel.nextDue <= now)) {
+				const auto tick = channel.scheduler.Advance();
+				pulses[i] = std::min(tick.pulseStrength, channel.maxStrength);
+				active = tick.nextInterval.count() > 0;
+				channel.active.store(active, std::memory_order_relaxed);
+				channel.nextDue = now + tick.nextInterval;
+			}
+
+			if (active || pulses[i] > 0) {
+				topPriority = anyActive ? std::max(topPriority, channel.priority) : channel.priority;
+				anyActive = true;
+			}
+			if (active) {
+				nextDue = std::min(nextDue, channel.nextDue);
+			}
+		}
+
+		// Channels below the highest running priority are muted, equal priorities blend to the strongest pulse
+		HapticScheduler::Tick output{};
+		for (std::size_t i = 0; i < count; ++i) {
+			if (channels[i].priority == topPriority) {
+				output.pulseStrength = std::max(output.pulseStrength, pulses[i]);
+			}
+		}
+
+		if (nextDue != std::chrono::steady_clock::time_point::max()) {
+			const auto untilNext = std::chrono::ceil<std::chrono::milliseconds>(nextDue - now);
+			output.nextInterval = std::max(untilNext, kMinOutputInterval);
+		}
+		return output;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+#include "core/HapticScheduler.h"
+
+namespace Haptics
+{
+	/// <summary>
+	/// Mixes several haptic sources of one hand into a single pulse stream. Every channel has its own scheduler. While a channel
+	/// is running, channels with a lower priority are muted; channels of the same priority blend to the strongest pulse, clamped
+	/// to each channel's maximum. At most one pulse is sent per tick, so sources never stack pulses on the same controller.
+	/// </summary>
+	class HapticMixer
+	{
+	public:
+		constexpr static std::size_t kMaxChannels = 8;
+
+		// Shortest time between two output pulses
+		constexpr static std::chrono::milliseconds kMinOutputInterval = std::chrono::milliseconds(5);
+
+		/// <summary>
+		/// Opens a channel. Returns its index or -1 if all channels are taken. Channels are never closed.
+		/// </summary>
+		int AddChannel(int priority, float maxStrength);
+
+		[[nodiscard]] bool IsValidChannel(int channel) const;
+
+		/// <summary>
+		/// Queues an event on a channel. Returns true if the mixer has to be advanced right away, otherwise the event starts
+		/// once the channel's current pulse interval is over.
+		/// </summary>
+		bool Schedule(int channel, const HapticEvent& event);
+
+		/// <summary>
+		/// Steps all channels that are due and returns the mixed pulse. The interval of the tick is the time until the next channel is due.
+		/// </summary>
+		HapticScheduler::Tick Advance(std::chrono::steady_clock::time_point now);
+
+	private:
+		struct Channel
+		{
+			int priority{ 0 };
+			float maxStrength{ 1.0f };
+			HapticScheduler scheduler;
+
+			std::atomic<bool> wake{ false };
+			std::atomic<bool> active{ false };
+			std::chrono::steady_clock::time_point nextDue{};  // Only touched by the thread calling Advance
+		};
+
+		std::mutex channelsMutex;  // Guards adding channels
+		std::array<Channel, kMaxChannels> channels;
+		std::atomic<std::size_t> channelCount{ 0 };
+	};
+}
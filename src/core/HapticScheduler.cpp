@@ -0,0 +1,63 @@
+#include "core/HapticScheduler.h"
+
+#include <algorithm>
+
+#include "core/Metrics.h"
+
+namespace Haptics
+{
+	void HapticScheduler::Schedule(const HapticEvent& event)
+	{
+		std::lock_guard lock(eventsMutex);
+		if (event.interruptPulse || event.replaceScheduledEvents) {
+			if (eventsCount > 0) {
+				Metrics::Increment(Metrics::Counter::kHapticEventsDropped, eventsCount);
+			}
+			eventsCount = 0;
+		} else if (eventsCount == kMaxQueuedEvents) {
+			Metrics::Increment(Metrics::Counter::kHapticEventsDropped);
+			eventsHead = (eventsHead + 1) % kMaxQueuedEvents;
+			eventsCount--;
+		}
+		events[(eventsHead + eventsCount) % kMaxQueuedEvents] = event;
+		eventsCount++;
+	}
+
+	HapticScheduler::Tick HapticScheduler::Advance()
+	{
+		{
+			std::lock_guard lock(eventsMutex);
+
+			if (eventsCount > 0) {
+				const HapticEvent& nextEvent = events[eventsHead];
+
+				// Replace the active event if requested or once the current one is done
+				if (nextEvent.interruptPulse || activeEvent.pulses <= 0) {
+					activeEvent = nextEvent;
+					eventsHead = (eventsHead + 1) % kMaxQueuedEvents;
+					eventsCount--;
+				}
+			}
+		}
+
+		const bool hasWork = (activeEvent.pulses > 0) || activeEvent.remainAfterCompletion;
+		if (!hasWork) {
+			return {};
+		}
+
+		Tick tick{};
+		if (activeEvent.pulseStrength > 0 && activeEvent.pulseStrength <= 1 && activeEvent.pulseInterval >= 5) {
+			tick.pulseStrength = activeEvent.pulseStrength;
+		}
+
+		if (activeEvent.pulses > 0) {
+			activeEvent.pulses--;
+		}
+
+		if (activeEvent.pulseInterval > 0) {
+			tick.nextInterval = std::chrono::milliseconds(std::max(activeEvent.pulseInterval, 5));
+		}
+
+		return tick;
+	}
+}
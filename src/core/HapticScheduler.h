@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+namespace Haptics
+{
+	struct HapticEvent
+	{
+		int pulseInterval = 0;
+		float pulseStrength = 0;
+		int pulses = 0;  // The (minimum) number of pulses to perform.
+
+		bool interruptPulse = false;  // If true, all currently active/queued pulses will be skipped and this event will play immediately.
+		bool remainAfterCompletion = true;  // If enabled the pulse parameters will remain active after the event is completed, until a new event is scheduled.
+		bool replaceScheduledEvents = true;
+	};
+
+	/// <summary>
+	/// Game independent part of the hand haptics. Holds the event queue and decides what to pulse on each worker tick.
+	/// The queue is a fixed ring, if it is full the oldest pending event is dropped.
+	/// </summary>
+	class HapticScheduler
+	{
+	public:
+		struct Tick
+		{
+			float pulseStrength = 0;  // Strength of the pulse to trigger now, 0 if no pulse should be sent.
+			std::chrono::milliseconds nextInterval{ 0 };  // When to tick again, 0 to wait for the next scheduled event.
+		};
+
+		void Schedule(const HapticEvent& event);
+		Tick Advance();
+
+	private:
+		constexpr static std::size_t kMaxQueuedEvents = 16;
+
+		std::mutex eventsMutex;
+		std::array<HapticEvent, kMaxQueuedEvents> events{};
+		std::size_t eventsHead{ 0 };
+		std::size_t eventsCount{ 0 };
+		HapticEvent activeEvent = HapticEvent{};
+	};
+}
@@ -0,0 +1,67 @@
+#include "core/Metrics.h"
+
+#include <atomic>
+#include <cstddef>
+
+namespace Metrics
+{
+	namespace
+	{
+		// More threads than shards just share them, the counters stay correct
+		constexpr std::size_t kMaxShards = 16;
+
+		struct alignas(64) Shard
+		{
+			std::array<std::atomic<std::uint64_t>, kCounterCount> counters{};
+			std::array<std::array<std::atomic<std::uint64_t>, kHistogramBuckets>, kHistogramCount> histograms{};
+		};
+
+		std::array<Shard, kMaxShards> g_shards;
+		std::atomic<std::size_t> g_nextShard{ 0 };
+
+		Shard& LocalShard()
+		{
+			thread_local Shard& shard = g_shards[g_nextShard.fetch_add(1, std::memory_order_relaxed) % kMaxShards];
+			return shard;
+		}
+	}
+
+	void Increment(Counter counter, std::uint64_t amount)
+	{
+		LocalShard().counters[static_cast<std::size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+	}
+
+	void Record(Histogram histogram, std::uint64_t value)
+	{
+		LocalShard().histograms[static_cast<std::size_t>(histogram)][BucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void Collect(SnapshotData& out)
+	{
+		out.counters.fill(0);
+		for (auto& buckets : out.histograms) {
+			buckets.fill(0);
+		}
+
+		for (const auto& shard : g_shards) {
+			for (std::size_t i = 0; i < kCounterCount; ++i) {
+				out.counters[i] += shard.counters[i].load(std::memory_order_relaxed);
+			}
+			for (std::size_t h = 0; h < kHistogramCount; ++h) {
+				for (std::size_t b = 0; b < kHistogramBuckets; ++b) {
+					out.histograms[h][b] += shard.histograms[h][b].load(std::memory_order_relaxed);
+				}
+			}
+		}
+	}
+
+	void Publish(SharedSnapshot& target, const SnapshotData& data)
+	{
+		target.data.Write(data);
+	}
+
+	bool Read(const SharedSnapshot& source, SnapshotData& out, int attempts)
+	{
+		return source.data.Read(out, attempts);
+	}
+}
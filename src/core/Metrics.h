@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+#include "core/MetricsLayout.h"
+
+namespace Metrics
+{
+	/// <summary>
+	/// Adds to a counter. Lock free, each thread writes to its own shard so hot threads don't share cache lines.
+	/// </summary>
+	void Increment(Counter counter, std::uint64_t amount = 1);
+
+	// Adds a sample to the log2 bucket of its value
+	void Record(Histogram histogram, std::uint64_t value);
+
+	/// <summary>
+	/// Sums all shards. Values are monotonic, readers derive rates from two snapshots.
+	/// </summary>
+	void Collect(SnapshotData& out);
+
+	// Writes the data into the snapshot with the seqlock protocol, there must only be one writer.
+	void Publish(SharedSnapshot& target, const SnapshotData& data);
+
+	// Copies a consistent snapshot. Returns false if the writer was busy for all attempts.
+	bool Read(const SharedSnapshot& source, SnapshotData& out, int attempts = 16);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+
+#include "core/SeqLock.h"
+
+namespace Metrics
+{
+	// Append only, readers match counters by index. Bump kLayoutVersion on anything else.
+	enum class Counter : std::uint32_t
+	{
+		kCasterEvents,
+		kHapticPulses,
+		kHapticEventsDropped,
+		kAttackEventsInjected,
+		kRepresses,
+		kSuppressedInputs,
+		kConfigWrites,
+		kWatchdogTrips,
+		kInjectionsMerged,
+		kInjectionsDropped,
+
+		kCount
+	};
+
+	enum class Histogram : std::uint32_t
+	{
+		kCasterHookNanoseconds,  // Per update of one of the player's casters, NPC casters are not timed
+
+		kCount
+	};
+
+	inline constexpr std::array<std::string_view, static_cast<std::size_t>(Counter::kCount)> kCounterNames{
+		"caster_events",
+		"haptic_pulses",
+		"haptic_events_dropped",
+		"attack_events_injected",
+		"represses",
+		"suppressed_inputs",
+		"config_writes",
+		"watchdog_trips",
+		"injections_merged",
+		"injections_dropped",
+	};
+
+	inline constexpr std::array<std::string_view, static_cast<std::size_t>(Histogram::kCount)> kHistogramNames{
+		"caster_hook_ns",
+	};
+
+	constexpr std::uint32_t kLayoutMagic = 0x52565049;  // "IPVR"
+	constexpr std::uint32_t kLayoutVersion = 2;
+	constexpr std::size_t kCounterCount = static_cast<std::size_t>(Counter::kCount);
+	constexpr std::size_t kHistogramCount = static_cast<std::size_t>(Histogram::kCount);
+
+	// Bucket i counts values in [2^(i-1), 2^i), bucket 0 counts zeros and the last bucket everything above.
+	constexpr std::size_t kHistogramBuckets = 32;
+
+	constexpr std::size_t BucketFor(std::uint64_t value)
+	{
+		const auto bucket = static_cast<std::size_t>(std::bit_width(value));
+		return bucket < kHistogramBuckets ? bucket : kHistogramBuckets - 1;
+	}
+
+	/// <summary>
+	/// Plain values of all metrics at one point in time.
+	/// </summary>
+	struct SnapshotData
+	{
+		std::uint64_t publishedAtNanoseconds{ 0 };  // Steady clock of the publishing process
+		std::array<std::uint64_t, kCounterCount> counters{};
+		std::array<std::array<std::uint64_t, kHistogramBuckets>, kHistogramCount> histograms{};
+	};
+
+	/// <summary>
+	/// Layout of the shared memory segment. The data sits in a seqlock, see Utils::SeqLock.
+	/// </summary>
+	struct SharedSnapshot
+	{
+		std::uint32_t magic{ kLayoutMagic };
+		std::uint32_t version{ kLayoutVersion };
+		std::uint32_t size{ sizeof(SharedSnapshot) };
+		std::uint32_t reserved{ 0 };
+		Utils::SeqLock<SnapshotData> data;
+	};
+
+	static_assert(std::atomic<std::uint32_t>::is_always_lock_free && std::atomic_ref<std::uint64_t>::is_always_lock_free,
+		"The seqlock must be usable across processes");
+
+	// Name of the segment on Windows
+	inline constexpr char kSharedMemoryName[] = "Local\\ImmersiveSpellcastingVR_Metrics";
+
+	// Name of the POSIX shared memory segment the Linux tools use
+	inline constexpr char kPosixSharedMemoryName[] = "/ImmersiveSpellcastingVR_Metrics";
+}
@@ -0,0 +1,33 @@
+#include "core/PatchPlanner.h"
+
+#include <cstring>
+
+namespace Utils::PatchPlanner
+{
+	bool IsValid(const PatchTarget& target)
+	{
+		return !target.offsets.empty() && !target.original.empty();
+	}
+
+	std::optional<std::uintptr_t> ResolveAddress(std::uintptr_t moduleBase, const PatchTarget& target)
+	{
+		if (moduleBase == 0 || !IsValid(target)) {
+			return std::nullopt;
+		}
+
+		for (const auto offset : target.offsets) {
+			const auto address = moduleBase + offset;
+			const auto* current_data = reinterpret_cast<const std::uint8_t*>(address);
+			if (std::memcmp(current_data, target.original.data(), target.original.size()) == 0) {
+				return address;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	std::span<const std::uint8_t> BytesFor(const PatchTarget& target, bool enabled)
+	{
+		return enabled ? target.patched : target.original;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Utils
+{
+	struct PatchTarget
+	{
+		std::string name;
+		std::vector<std::uintptr_t> offsets;
+		std::vector<std::uint8_t> original;
+		std::vector<std::uint8_t> patched;
+	};
+
+	/// <summary>
+	/// Game independent part of the BinaryPatcher: works out where a patch goes and what to write, without touching page protection.
+	/// </summary>
+	namespace PatchPlanner
+	{
+		[[nodiscard]] bool IsValid(const PatchTarget& target);
+
+		/// <summary>
+		/// Returns the first address (moduleBase + offset) whose bytes match the target's original bytes.
+		/// </summary>
+		[[nodiscard]] std::optional<std::uintptr_t> ResolveAddress(std::uintptr_t moduleBase, const PatchTarget& target);
+
+		/// <summary>
+		/// Bytes that have to be written to (un)apply the target.
+		/// </summary>
+		[[nodiscard]] std::span<const std::uint8_t> BytesFor(const PatchTarget& target, bool enabled);
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Utils
+{
+	/// <summary>
+	/// Holds a small plain struct for one writer and any number of lock free readers. The sequence is odd while the value is
+	/// being written, readers retry until they saw the same even sequence before and after copying.
+	/// </summary>
+	template <class T>
+	class SeqLock
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "The value is copied word by word");
+		static_assert(sizeof(T) % sizeof(std::uint64_t) == 0, "Pad the value to a multiple of 8 bytes");
+
+	public:
+		// Must only be called from one thread at a time
+		void Write(const T& value)
+		{
+			Words source;
+			std::memcpy(source.data(), &value, sizeof(T));
+
+			const auto current = sequence.load(std::memory_order_relaxed);
+			sequence.store(current + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			for (std::size_t i = 0; i < kWords; ++i) {
+				std::atomic_ref(words[i]).store(source[i], std::memory_order_relaxed);
+			}
+
+			sequence.store(current + 2, std::memory_order_release);
+		}
+
+		// Copies a consistent value. Returns false if the writer was busy for all attempts.
+		bool Read(T& out, int attempts = 16) const
+		{
+			Words copy;
+			for (int attempt = 0; attempt < attempts; ++attempt) {
+				const auto before = sequence.load(std::memory_order_acquire);
+				if (before & 1) {
+					continue;
+				}
+
+				for (std::size_t i = 0; i < kWords; ++i) {
+					copy[i] = std::atomic_ref(words[i]).load(std::memory_order_relaxed);
+				}
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (sequence.load(std::memory_order_relaxed) == before) {
+					std::memcpy(static_cast<void*>(&out), copy.data(), sizeof(T));
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Changes with every write, readers can compare it to skip copying an unchanged value
+		[[nodiscard]] std::uint32_t Sequence() const { return sequence.load(std::memory_order_acquire); }
+
+	private:
+		constexpr static std::size_t kWords = sizeof(T) / sizeof(std::uint64_t);
+		using Words = std::array<std::uint64_t, kWords>;
+
+		std::atomic<std::uint32_t> sequence{ 0 };
+		mutable Words words{};  // Only mutable because atomic_ref needs a non-const reference to load
+	};
+}
@@ -0,0 +1,60 @@
+#include "core/SpellTable.h"
+
+#include <algorithm>
+#include <execution>
+
+namespace Spells
+{
+	namespace
+	{
+		// Charge times below this are not felt as a charge
+		constexpr float kInstantChargeTime = 0.1f;
+	}
+
+	bool ShouldInvertInput(CastingType castingType, std::string_view name)
+	{
+		return castingType == CastingType::kConcentration && name != "Telekinesis";
+	}
+
+	SpellInfo Describe(const SpellSource& source)
+	{
+		SpellInfo info{
+			.formID = source.formID,
+			.chargeTime = source.chargeTime,
+			.spellType = source.spellType,
+			.castingType = source.castingType,
+			.delivery = source.delivery,
+			.learnable = source.learnable,
+			.invertInput = ShouldInvertInput(source.castingType, source.name),
+		};
+
+		if (info.invertInput) {
+			info.hapticProfile = HapticProfile::kConcentration;
+		} else if (source.chargeTime < kInstantChargeTime) {
+			info.hapticProfile = HapticProfile::kInstant;
+		}
+		return info;
+	}
+
+	SpellTable SpellTable::Build(std::span<const SpellSource> sources)
+	{
+		SpellTable table;
+		table.entries.resize(sources.size());
+		std::transform(std::execution::par, sources.begin(), sources.end(), table.entries.begin(), Describe);
+
+		// Stable, so the first occurrence of a duplicate stays in front
+		std::stable_sort(std::execution::par, table.entries.begin(), table.entries.end(), [](const SpellInfo& lhs, const SpellInfo& rhs) {
+			return lhs.formID < rhs.formID;
+		});
+		const auto duplicates = std::ranges::unique(table.entries, {}, &SpellInfo::formID);
+		table.entries.erase(duplicates.begin(), duplicates.end());
+		table.entries.shrink_to_fit();
+		return table;
+	}
+
+	const SpellInfo* SpellTable::Find(std::uint32_t formID) const
+	{
+		const auto it = std::ranges::lower_bound(entries, formID, {}, &SpellInfo::formID);
+		return (it != entries.end() && it->formID == formID) ? &*it : nullptr;
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Spells
+{
+	// Mirror RE::MagicSystem::SpellType, RE::MagicSystem::CastingType and RE::MagicSystem::Delivery, kept free of game headers like CasterState.h
+	enum class SpellType : std::uint8_t
+	{
+		kSpell = 0,
+		kDisease,
+		kPower,
+		kLesserPower,
+		kAbility,
+		kPoison,
+		kEnchantment,
+		kPotion,
+		kWortCraft,
+		kLeveledSpell,
+		kAddiction,
+		kVoicePower,
+		kStaffEnchantment,
+		kScroll,
+	};
+
+	enum class CastingType : std::uint8_t
+	{
+		kConstantEffect = 0,
+		kFireAndForget,
+		kConcentration,
+		kScroll,
+	};
+
+	enum class Delivery : std::uint8_t
+	{
+		kSelf = 0,
+		kTouch,
+		kAimed,
+		kTargetActor,
+		kTargetLocation,
+	};
+
+	// Which haptic pattern fits a spell
+	enum class HapticProfile : std::uint8_t
+	{
+		kCharged,  // Charges up and is released once
+		kInstant,  // Released without a noticeable charge
+		kConcentration,  // Held open while casting
+	};
+
+	/// <summary>
+	/// Properties of a spell as read from the game.
+	/// </summary>
+	struct SpellSource
+	{
+		std::uint32_t formID{ 0 };
+		SpellType spellType{ SpellType::kSpell };
+		CastingType castingType{ CastingType::kFireAndForget };
+		Delivery delivery{ Delivery::kSelf };
+		float chargeTime{ 0.0f };
+		bool learnable{ false };  // Taught by a spell tome or known by the player from the start
+		std::string_view name;  // Only has to stay valid while the table is built
+	};
+
+	/// <summary>
+	/// What the hot paths need to know about a spell, precomputed once.
+	/// </summary>
+	struct SpellInfo
+	{
+		std::uint32_t formID{ 0 };
+		float chargeTime{ 0.0f };  // As loaded, before any charge rebalancing. The haptic profile is classified from it.
+		SpellType spellType{ SpellType::kSpell };
+		CastingType castingType{ CastingType::kFireAndForget };
+		Delivery delivery{ Delivery::kSelf };
+		bool learnable{ false };
+		bool invertInput{ false };  // Cast while the hand is open instead of closed
+		HapticProfile hapticProfile{ HapticProfile::kCharged };
+	};
+
+	// Concentration spells are cast with an open hand, except Telekinesis which is aimed like a fire and forget spell
+	[[nodiscard]] bool ShouldInvertInput(CastingType castingType, std::string_view name);
+
+	[[nodiscard]] SpellInfo Describe(const SpellSource& source);
+
+	/// <summary>
+	/// Immutable spell metadata sorted by form ID. Lookups are a binary search over a flat array.
+	/// </summary>
+	class SpellTable
+	{
+	public:
+		SpellTable() = default;
+
+		/// <summary>
+		/// Describes all spells in parallel and sorts them. If a form ID appears twice the first occurrence is kept.
+		/// </summary>
+		[[nodiscard]] static SpellTable Build(std::span<const SpellSource> sources);
+
+		// Returns nullptr if the spell is not in the table
+		[[nodiscard]] const SpellInfo* Find(std::uint32_t formID) const;
+
+		[[nodiscard]] std::size_t Size() const { return entries.size(); }
+		[[nodiscard]] std::span<const SpellInfo> Entries() const { return entries; }
+
+	private:
+		std::vector<SpellInfo> entries;
+	};
+}
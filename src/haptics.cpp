@@ -5,82 +5,75 @@
 #include <algorithm>
 #include <cmath>
 #include <atomic>
+#include <mutex>
 #include <sksevr_api.h>
 
+#include "core/AllocAudit.h"
+#include "core/Metrics.h"
+#include "utils/TaskPool.h"
+
 using namespace std::chrono;
 
 namespace Haptics
 {
-	HandHaptics::HandHaptics(bool isLeftHand) :
+	namespace
+	{
+		struct PulseArgs
+		{
+			RE::BSOpenVR* vrsystem;
+			bool isLeftHand;
+			float strength;
+		};
+
+		// Pulses are queued at up to 200 Hz per hand, so they reuse pooled task delegates instead of allocating one each
+		Utils::TaskPool<PulseArgs> g_pulseTasks{ [](const PulseArgs& args) {
+			args.vrsystem->TriggerHapticPulse(!args.isLeftHand, args.strength);
+		} };
+	}
+
+	HandHaptics::HandHaptics(bool isLeftHand, Utils::Clock& clock) :
+		TimedWorker(clock),
 		isLeftHand(isLeftHand)
 	{
 		g_vrsystem = RE::BSOpenVR::GetSingleton();
 		handName = isLeftHand ? "Left" : "Right";
 		minInterval.store(std::chrono::milliseconds(0), std::memory_order::relaxed);
+		mixer.AddChannel(kSpellChannelPriority, 1.0f);
 		Start();
-		//logger::info("{} Hand Haptics: Initialized successfully.", handName);
+		ISPVR_LOG_DEBUG("{} Hand Haptics: Initialized successfully.", handName);
 	}
 
 	void HandHaptics::ScheduleEvent(HapticEvent event)
 	{
-		//logger::info("{} p{}", isLeftHand ? "Left" : "Right", event.pulseStrength);
-		{
-			std::lock_guard lock(eventsMutex);
-			if (event.interruptPulse || event.replaceScheduledEvents) {
-				events.clear();
-			}
-			events.push_back(event);
-		}
+		ScheduleEvent(kSpellChannel, event);
+	}
 
-		const bool shouldNotify = event.interruptPulse || minInterval.load(std::memory_order::relaxed).count() <= 0;
-		if (shouldNotify) {
+	void HandHaptics::ScheduleEvent(int channel, HapticEvent event)
+	{
+		ISPVR_LOG_TRACE("{} scheduled p{} on channel {}", handName, event.pulseStrength, channel);
+		if (mixer.Schedule(channel, event)) {
 			// Wake worker to process new input promptly
 			Notify();
 		}
 	}
 
-	void HandHaptics::Work()
+	int HandHaptics::AddChannel(int priority, float maxStrength)
 	{
-		{
-			std::lock_guard lock(eventsMutex);
-
-			if (!events.empty()) {
-				const HapticEvent nextEvent = events.front();
-
-				// Replace the active event if requested or once the current one is done
-				if (nextEvent.interruptPulse || activeEvent.pulses <= 0) {
-					activeEvent = nextEvent;
-					events.pop_front();
-				}
-			}
-		}
-
-		const bool hasWork = (activeEvent.pulses > 0) || activeEvent.remainAfterCompletion;
-
-		if (!hasWork) {
-			minInterval.store(std::chrono::milliseconds(0), std::memory_order::relaxed);
-			return;
-		}
-
-		if (activeEvent.pulseStrength > 0 && activeEvent.pulseStrength <= 1 && activeEvent.pulseInterval >= 5) {
-			//std::scoped_lock lock(g_pulseMutex);
-			auto vrsystem = g_vrsystem;
-			auto lefthand = isLeftHand;
-			auto pulseStrength = activeEvent.pulseStrength;
-			SKSE::GetTaskInterface()->AddTask([vrsystem, lefthand, pulseStrength] { vrsystem->TriggerHapticPulse(!lefthand, pulseStrength); });
+		return mixer.AddChannel(priority, maxStrength);
+	}
 
-		}
+	void HandHaptics::Work()
+	{
+		ISPVR_ALLOC_AUDIT_SCOPE("HandHaptics::Work");
+		const auto tick = mixer.Advance(clock.Now());
 
-		if (activeEvent.pulses > 0) {
-			activeEvent.pulses--;
+		if (tick.pulseStrength > 0) {
+			ISPVR_LOG_TRACE("{} pulse {}", handName, tick.pulseStrength);
+			Metrics::Increment(Metrics::Counter::kHapticPulses);
+			g_pulseTasks.AddTask({ .vrsystem = g_vrsystem, .isLeftHand = isLeftHand, .strength = tick.pulseStrength });
 		}
 
-		if (activeEvent.pulseInterval > 0) {
-			const auto interval = std::chrono::milliseconds(std::max(activeEvent.pulseInterval, 5));
-			minInterval.store(interval, std::memory_order::relaxed);
-		} else {
-			minInterval.store(std::chrono::milliseconds(0), std::memory_order::relaxed);
-		}
+		minInterval.store(tick.nextInterval, std::memory_order::relaxed);
 	}
 
 	static HandHaptics leftHH(true);
@@ -91,14 +84,28 @@ namespace Haptics
 		return &(getLeftHand ? leftHH : rightHH);
 	}
 
-	void Pause(bool paused)
+	int AddChannel(int priority, float maxStrength)
 	{
-		if (paused) {
-			leftHH.Stop();
-			rightHH.Stop();
-		} else {
-			leftHH.Start();
-			rightHH.Start();
+		// Both mixers only ever open channels through here, so the indices stay in sync
+		static std::mutex channelMutex;
+		std::scoped_lock lock(channelMutex);
+		const int channel = leftHH.AddChannel(priority, maxStrength);
+		if (channel < 0 || rightHH.AddChannel(priority, maxStrength) != channel) {
+			return -1;
 		}
+		return channel;
+	}
+
+	void Pause(bool paused)
+	{
+		leftHH.Pause(paused);
+		rightHH.Pause(paused);
+	}
+
+	void SetFrameAligned(bool enabled)
+	{
+		auto* frames = enabled ? &Utils::FrameClock::Get() : nullptr;
+		leftHH.SetFrameClock(frames);
+		rightHH.SetFrameClock(frames);
 	}
 }
@@ -1,24 +1,15 @@
 #pragma once
 
+#include "core/HapticMixer.h"
 #include "utils/TimedWorker.h"
 
-#include <chrono>
-#include <deque>
-#include <mutex>
 #include <string>
 
 namespace Haptics
 {
-	struct HapticEvent
-	{
-		int pulseInterval = 0;
-		float pulseStrength = 0;
-		int pulses = 0;  // The (minimum) number of pulses to perform.
-
-		bool interruptPulse = false;  // If true, all currently active/queued pulses will be skipped and this event will play immediately.
-		bool remainAfterCompletion = true;  // If enabled the pulse parameters will remain active after the event is completed, until a new event is scheduled.
-		bool replaceScheduledEvents = true;
-	};
+	// Channel used by the spell charge haptics, opened first on every hand
+	constexpr int kSpellChannel = 0;
+	constexpr int kSpellChannelPriority = 0;
 
 	class HandHaptics : public Utils::TimedWorker
 	{
@@ -26,18 +17,19 @@ namespace Haptics
 		bool isLeftHand;
 		std::string handName;
 
-		HandHaptics(bool isLeftHand);
+		HandHaptics(bool isLeftHand, Utils::Clock& clock = Utils::Clock::Steady());
 
 		void ScheduleEvent(HapticEvent event);
+		void ScheduleEvent(int channel, HapticEvent event);
+
+		int AddChannel(int priority, float maxStrength);
 
 	private:
 		void Work() override;
 
 		RE::BSOpenVR* g_vrsystem;
 
-		std::mutex eventsMutex;
-		std::deque<HapticEvent> events;
-		HapticEvent activeEvent = HapticEvent{};
+		HapticMixer mixer;
 	};
 
 	extern HandHaptics leftHH;
@@ -45,5 +37,15 @@ namespace Haptics
 
 	HandHaptics* GetHandHaptics(bool getLeftHand);
 
+	/// <summary>
+	/// Opens a mixer channel with the same index on both hands. Returns the channel or -1 if none is left.
+	/// </summary>
+	int AddChannel(int priority, float maxStrength);
+
 	void Pause(bool paused);
+
+	/// <summary>
+	/// Switches both hands between timer driven waits and waking on game frames.
+	/// </summary>
+	void SetFrameAligned(bool enabled);
 }
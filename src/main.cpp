@@ -15,18 +15,26 @@
 #include "InputDispatcher.h"
 #include "ConfigManager.h"
 #include "InputInterceptor.h"
+#include "HandOrientation.h"
 #include "Settings.h"
 #include "ActionAllowedHook.h"
+#include "ChargeRebalance.h"
 #include "openvr.h"
 #include "utils.h"
 #include <windows.h>
 #include <haptics.h>
 #include "SpellChargeTracker.h"
+#include "SpellMetadata.h"
 #include "compat/HapticSkyrimVR.h"
 #include "compat/HapticSkyrimVRinterface001.h"
 #include "PCH.h"
 #include <compat/HIGGS.h>
 #include <AllowShoutWhileCasting.h>
+#include "utils/UITasks.h"
+#include "core/AllocAudit.h"
+#include "utils/MetricsExport.h"
+#include "api/CasterStateInterface.h"
+#include "api/HapticsInterface.h"
 
 using namespace RE;
 using namespace SKSE;
@@ -35,7 +43,27 @@ SKSE::PluginHandle g_pluginHandle;
 std::string g_pluginName;
 std::string g_pluginNameShort = "ImmersiveSpellcastingVR";
 
+Utils::Animation::EventRouter g_playerAnimationRouter;
+
 // Event Callbacks
+void OnPlayerEquipOut([[maybe_unused]] const RE::BSAnimationGraphEvent& event)
+{
+	// Refresh casting state after spell was equipped so it is immediately fired after draw. Also refresh after a weapon
+	InputInterceptor::RefreshCastingState();
+}
+
+void RegisterPlayerAnimationRoutes()
+{
+	static bool registered = false;
+	if (registered) {
+		return;
+	}
+
+	g_playerAnimationRouter.Register("Magic_Equip_Out", OnPlayerEquipOut);
+	g_playerAnimationRouter.Register("WeapEquip_Out", OnPlayerEquipOut);
+	registered = true;
+}
+
 void OnPlayerAnimationGraphEvent(const RE::BSAnimationGraphEvent& event)
 {
 	// Only run for player
@@ -46,38 +74,103 @@ void OnPlayerAnimationGraphEvent(const RE::BSAnimationGraphEvent& event)
 
 	//logger::info("Event: {}", event.tag.c_str());
 
-	// Refresh casting state after spell was equipped so it is immediately fired after draw. Also refresh after a weapon
-	if (event.tag == "Magic_Equip_Out" || event.tag == "WeapEquip_Out") {
-		InputInterceptor::RefreshCastingState();
+	g_playerAnimationRouter.Dispatch(event);
+}
+
+void RefreshHandOrientation()
+{
+	if (HandOrientation::Refresh()) {
+		logger::info("Left-handed mode {}", RE::BSOpenVRControllerDevice::IsLeftHandedMode() ? "enabled" : "disabled");
+	}
+}
+
+void ApplyFrameAlignedWorkers(const Config::Value& value)
+{
+	if (const auto* enabled = std::get_if<bool>(&value)) {
+		Haptics::SetFrameAligned(*enabled);
+		InputDispatcher::SetFrameAligned(*enabled);
 	}
 }
 
-void OnSaveLoadEvent([[maybe_unused]] RE::TESLoadGameEvent event)
+void ConnectFrameAlignedWorkers()
 {
+	static std::uint64_t configListenerId = 0;
+	if (configListenerId != 0) {
+		return;
+	}
+
+	auto& config = Config::Manager::GetSingleton();
+	ApplyFrameAlignedWorkers(config.GetValue(Settings::kAdvancedFrameAlignedWorkers));
+	configListenerId = config.AddListener(
+		[](std::string_view key, const Config::Value& value, [[maybe_unused]] Config::ChangeSource source) {
+			if (key == Settings::kAdvancedFrameAlignedWorkers) {
+				ApplyFrameAlignedWorkers(value);
+			}
+		});
+}
+
+void OnSaveLoadEvent([[maybe_unused]] const RE::TESLoadGameEvent& event)
+{
+	RefreshHandOrientation();
 	SpellChargeTracker::Install();
 	AllowShoutWhileCasting::Install();
 	ActionAllowedHook::Install();
 	Utils::Setup::PerformInteractiveSetup();
 
 	// Add a listener to player animations. This needs to be done once per save load
-	static auto playerAnimationGraphHandler = Utils::EventHandler<RE::BSAnimationGraphEvent>(OnPlayerAnimationGraphEvent);
+	static Utils::Events::Subscriber<RE::BSAnimationGraphEvent> playerAnimationSubscriber{ "PlayerAnimation", OnPlayerAnimationGraphEvent };
+	Utils::Events::Subscribe(playerAnimationSubscriber);
 	if (auto* player = RE::PlayerCharacter::GetSingleton()) {
-		player->AddAnimationGraphEventSink(playerAnimationGraphHandler);
+		player->AddAnimationGraphEventSink(&Utils::Events::Registry<RE::BSAnimationGraphEvent>::Get());
+	}
+}
+
+Tasks::Task ResumeCastingAfterMenu()
+{
+	// Let the casters interrupted by the menu wind down first, so the refreshed input starts a fresh cast instead of being swallowed
+	constexpr auto kSettleTimeout = std::chrono::milliseconds(250);
+	co_await Utils::UITasks::CasterStates(CasterStateTracker::ActualState::kIdle, kSettleTimeout);
+	InputInterceptor::RefreshCastingState();
+}
+
+void LogAllocAudit()
+{
+	if constexpr (AllocAudit::IsEnabled()) {
+		for (const auto* site = AllocAudit::FirstSite(); site; site = site->next) {
+			const auto scopes = site->scopes.load(std::memory_order_relaxed);
+			const auto allocations = site->allocations.load(std::memory_order_relaxed);
+			logger::debug("Alloc audit: {} allocated {} times ({} bytes) in {} runs", site->name, allocations, site->bytes.load(std::memory_order_relaxed), scopes);
+		}
 	}
 }
 
 void OnMenuOpenCloseEvent(const RE::MenuOpenCloseEvent& event)
 {
-	// Pause haptics while in menus
+	// Park haptics and dispatch workers while in menus. Only blocking menus change the in-game state, so HUD menus cost nothing here.
+	static std::atomic_bool workersPaused{ false };
 	const bool inGame = Utils::InGame();
-	Haptics::Pause(!inGame);
-	InputDispatcher::Pause(!inGame);
+	if (workersPaused.exchange(!inGame) != !inGame) {
+		Haptics::Pause(!inGame);
+		InputDispatcher::Pause(!inGame);
+		Utils::MetricsExport::Pause(!inGame);
+		logger::debug("Workers {} ({} worker threads created this session)", inGame ? "resumed" : "parked", Utils::TimedWorker::ThreadsCreated());
+		if (!inGame) {
+			const auto actionStats = ActionAllowedHook::GetStats();
+			logger::debug("ActionAllowedHook: {} calls, {} ns average", actionStats.calls, actionStats.calls ? actionStats.totalNanoseconds / actionStats.calls : 0);
+			LogAllocAudit();
+		}
+	}
 
 	// Only handle game relevant menus
 	if (!std::ranges::contains(Utils::kGameBlockingMenus, event.menuName.c_str())) {
 		return;
 	}
 
+	// Left-handed mode can only change in the settings menu, so re-check it whenever a blocking menu closes
+	if (!event.opening) {
+		RefreshHandOrientation();
+	}
+
 	// Interrupt hand casters
 	if (auto player = RE::PlayerCharacter::GetSingleton()) {
 		for (auto caster : { player->GetMagicCaster(RE::MagicSystem::CastingSource::kLeftHand), player->GetMagicCaster(RE::MagicSystem::CastingSource::kRightHand) }) {
@@ -87,7 +180,7 @@ void OnMenuOpenCloseEvent(const RE::MenuOpenCloseEvent& event)
 	if (!event.opening && inGame) {
 
 		if (Config::Manager::GetSingleton().Get<bool>(Settings::kInputCastAfterMenuExit, false)) {
-			InputInterceptor::RefreshCastingState();
+			Utils::UITasks::Spawn(ResumeCastingAfterMenu());
 		} else {
 			// Suppress active input until it has been released by the player
 			InputDispatcher::leftDisp.SuppressUntilCasterInactive();
@@ -112,9 +205,10 @@ void OnSKSEMessage(SKSE::MessagingInterface::Message* msg)
 		break;
 	case SKSE::MessagingInterface::kPostPostLoad:
 		{
-			static auto menuHandler = Utils::EventHandler<RE::MenuOpenCloseEvent>(OnMenuOpenCloseEvent);
+			static Utils::Events::Subscriber<RE::MenuOpenCloseEvent> menuSubscriber{ "MenuOpenClose", OnMenuOpenCloseEvent };
+			Utils::Events::Subscribe(menuSubscriber);
 			if (auto* ui = RE::UI::GetSingleton()) {
-				ui->AddEventSink(&menuHandler);
+				Utils::Events::Registry<RE::MenuOpenCloseEvent>::Get().Attach(ui);
 			}
 		}
 		break;
@@ -122,8 +216,18 @@ void OnSKSEMessage(SKSE::MessagingInterface::Message* msg)
 		{
 			//logger::info(FMT_STRING("kDataLoaded"), Plugin::NAME, Plugin::VERSION);
 			Config::Init();
+			RefreshHandOrientation();
+			RegisterPlayerAnimationRoutes();
+			ActionAllowedHook::ResolveActions();
+			// The hook stats are only read by the debug log when a menu opens, release builds don't pay for the timing
+			if constexpr (Log::IsCompiled(spdlog::level::debug)) {
+				ActionAllowedHook::SetCountersEnabled(true);
+			}
+			SpellMetadata::Refresh();
+			ChargeRebalance::ConnectToConfig();
 
 			InputInterceptor::ConnectToConfig();
+			ConnectFrameAlignedWorkers();
 		}
 		break;
 	}
@@ -143,6 +247,14 @@ extern "C" [[maybe_unused]] __declspec(dllexport) bool SKSEPlugin_Load(const SKS
 	g_pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
 	Utils::Setup::SetupLogger();
 
+	// Hot path allocations are counted and logged when the workers park. Break into an attached debugger on the first one of each path,
+	// logging from inside operator new is not safe.
+	AllocAudit::SetHandler([](const AllocAudit::Site&, std::size_t) {
+		if (::IsDebuggerPresent()) {
+			__debugbreak();
+		}
+	});
+
 	SKSE::AllocTrampoline(1 << 10, false); // Unused for now, might come in handy later when i use write_call/write_branch
 
 	auto messaging = SKSE::GetMessagingInterface();
@@ -151,10 +263,10 @@ extern "C" [[maybe_unused]] __declspec(dllexport) bool SKSEPlugin_Load(const SKS
 		return false;
 	}
 
-	static auto loadGameHandler = Utils::EventHandler<RE::TESLoadGameEvent>(OnSaveLoadEvent);
-	auto* scriptEventSource = RE::ScriptEventSourceHolder::GetSingleton();
-	if (scriptEventSource) {
-		scriptEventSource->AddEventSink(&loadGameHandler);
+	static Utils::Events::Subscriber<RE::TESLoadGameEvent> loadGameSubscriber{ "LoadGame", OnSaveLoadEvent };
+	Utils::Events::Subscribe(loadGameSubscriber);
+	if (auto* scriptEventSource = RE::ScriptEventSourceHolder::GetSingleton()) {
+		Utils::Events::Registry<RE::TESLoadGameEvent>::Get().Attach(scriptEventSource);
 	}
 
 	auto* papyrus = SKSE::GetPapyrusInterface();
@@ -164,6 +276,9 @@ extern "C" [[maybe_unused]] __declspec(dllexport) bool SKSEPlugin_Load(const SKS
 	}
 
 	InputInterceptor::Install(a_skse);
+	Api::Haptics::Install();
+	Api::CasterState::Install();
+	Utils::MetricsExport::Install();
 
 	logger::info("{} loaded!", g_pluginName);
 	return true;
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "utils/EventHandler.h"
+#include "utils/EventRegistry.h"
 #include "utils/GameState.h"
 #include "utils/Console.h"
 #include "utils/MessageBox.h"
@@ -8,3 +8,4 @@
 #include "utils/Setup.h"
 #include "utils/Animation.h"
 #include "utils/LogUtils.h"
+#include "utils/Log.h"
@@ -51,4 +51,54 @@ namespace Utils::Animation
 			}
 		}
 	}
+
+	bool EventRouter::Register(std::string_view tag, Handler handler)
+	{
+		const auto index = routeCount.load(std::memory_order_relaxed);
+		if (!handler || index >= kMaxRoutes) {
+			logger::warn("Animation event route for '{}' could not be registered", tag);
+			return false;
+		}
+
+		auto& route = routes[index];
+		route.tag = RE::BSFixedString(tag);
+		route.handler = handler;
+		routeCount.store(index + 1, std::memory_order_release);
+		return true;
+	}
+
+	std::size_t EventRouter::Dispatch(const RE::BSAnimationGraphEvent& event)
+	{
+		// Equal fixed strings share the same pool entry, comparing the data pointers is enough
+		const auto* tag = event.tag.data();
+		const auto count = routeCount.load(std::memory_order_acquire);
+		const bool counting = countersEnabled.load(std::memory_order_relaxed);
+
+		std::size_t handled = 0;
+		for (std::size_t i = 0; i < count; ++i) {
+			auto& route = routes[i];
+			if (route.tag.data() != tag) {
+				continue;
+			}
+
+			if (counting) {
+				route.hits.fetch_add(1, std::memory_order_relaxed);
+			}
+			route.handler(event);
+			++handled;
+		}
+		return handled;
+	}
+
+	std::uint64_t EventRouter::GetCount(std::string_view tag) const
+	{
+		std::uint64_t hits = 0;
+		const auto count = routeCount.load(std::memory_order_acquire);
+		for (std::size_t i = 0; i < count; ++i) {
+			if (routes[i].tag == tag) {
+				hits += routes[i].hits.load(std::memory_order_relaxed);
+			}
+		}
+		return hits;
+	}
 }
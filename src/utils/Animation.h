@@ -1,6 +1,50 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "RE/Skyrim.h"
+
 namespace Utils::Animation
 {
 	void DumpPlayerGraphVariables();
+
+	/// <summary>
+	/// Routes animation graph events to handlers registered per tag. Tags are interned as BSFixedString on registration, so
+	/// matching an event is a pointer compare per route and unrelated events cost next to nothing.
+	/// Routes must be registered after the game's string pool is up (kDataLoaded or later).
+	/// </summary>
+	class EventRouter
+	{
+	public:
+		using Handler = void (*)(const RE::BSAnimationGraphEvent&);
+
+		constexpr static std::size_t kMaxRoutes = 16;
+
+		bool Register(std::string_view tag, Handler handler);
+
+		/// <summary>
+		/// Calls all handlers registered for the event's tag. Returns the number of handlers called.
+		/// </summary>
+		std::size_t Dispatch(const RE::BSAnimationGraphEvent& event);
+
+		// Per-tag hit counters, disabled by default
+		void SetCountersEnabled(bool enabled) { countersEnabled.store(enabled, std::memory_order_relaxed); }
+		[[nodiscard]] std::uint64_t GetCount(std::string_view tag) const;
+
+	private:
+		struct Route
+		{
+			RE::BSFixedString tag;
+			Handler handler{ nullptr };
+			std::atomic<std::uint64_t> hits{ 0 };
+		};
+
+		std::array<Route, kMaxRoutes> routes;
+		std::atomic<std::size_t> routeCount{ 0 };
+		std::atomic<bool> countersEnabled{ false };
+	};
 }
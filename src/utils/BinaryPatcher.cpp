@@ -3,7 +3,6 @@
 #include "REL/Relocation.h"
 #include "REX/W32/KERNEL32.h"
 
-#include <cstring>
 
 namespace Utils
 {
@@ -38,28 +37,20 @@ namespace Utils
 				continue;
 			}
 
-			if (target.data.offsets.empty() || target.data.original.empty()) {
+			if (!PatchPlanner::IsValid(target.data)) {
 				logger::warn("{}: invalid patch target {}; skipping patch for that function", logPrefix, target.data.name);
 				++mismatches;
 				continue;
 			}
 
-			bool matched = false;
-			for (const auto offset : target.data.offsets) {
-				const auto address = moduleBase + offset;
-				const auto* current_data = reinterpret_cast<const std::uint8_t*>(address);
-				if (std::memcmp(current_data, target.data.original.data(), target.data.original.size()) == 0) {
-					target.address = address;
-					matched = true;
-					break;
-				}
-			}
-
-			if (!matched) {
+			const auto address = PatchPlanner::ResolveAddress(moduleBase, target.data);
+			if (!address) {
 				logger::warn("{}: data mismatch for {}; skipping patch for that function", logPrefix, target.data.name);
 				++mismatches;
 				continue;
 			}
+
+			target.address = *address;
 		}
 
 		return mismatches;
@@ -74,7 +65,7 @@ namespace Utils
 				continue;
 			}
 
-			const auto& bytes = enabled ? target.data.patched : target.data.original;
+			const auto bytes = PatchPlanner::BytesFor(target.data, enabled);
 			if (bytes.empty()) {
 				continue;
 			}
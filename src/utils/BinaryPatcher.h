@@ -7,18 +7,14 @@
 #include <string_view>
 #include <vector>
 
+#include "core/PatchPlanner.h"
+
 namespace Utils
 {
 	class BinaryPatcher
 	{
 	public:
-		struct PatchTarget
-		{
-			std::string name;
-			std::vector<std::uintptr_t> offsets;
-			std::vector<std::uint8_t> original;
-			std::vector<std::uint8_t> patched;
-		};
+		using PatchTarget = Utils::PatchTarget;
 
 		BinaryPatcher(
 			std::string_view moduleName,
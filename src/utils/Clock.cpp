@@ -0,0 +1,20 @@
+#include "utils/Clock.h"
+
+namespace Utils
+{
+	namespace
+	{
+		class SteadyClock final : public Clock
+		{
+		public:
+			[[nodiscard]] time_point Now() const override { return std::chrono::steady_clock::now(); }
+			[[nodiscard]] bool IsRealTime() const override { return true; }
+		};
+	}
+
+	Clock& Clock::Steady()
+	{
+		static SteadyClock singleton;
+		return singleton;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace Utils
+{
+	/// <summary>
+	/// Time source used by workers. Defaults to the steady clock but can be swapped for a ManualClock to step logic deterministically.
+	/// </summary>
+	class Clock
+	{
+	public:
+		using duration = std::chrono::steady_clock::duration;
+		using time_point = std::chrono::steady_clock::time_point;
+
+		virtual ~Clock() = default;
+
+		[[nodiscard]] virtual time_point Now() const = 0;
+
+		// Returns true if Now() follows real time, so it can be used for condition variable timeouts.
+		[[nodiscard]] virtual bool IsRealTime() const { return false; }
+
+		[[nodiscard]] static Clock& Steady();
+	};
+
+	/// <summary>
+	/// Clock that only moves when advanced explicitly. A simulated second costs nothing.
+	/// </summary>
+	class ManualClock final : public Clock
+	{
+	public:
+		[[nodiscard]] time_point Now() const override
+		{
+			return time_point(duration(ticks.load(std::memory_order::acquire)));
+		}
+
+		void Advance(duration delta) { ticks.fetch_add(delta.count(), std::memory_order::acq_rel); }
+		void Set(time_point timePoint) { ticks.store(timePoint.time_since_epoch().count(), std::memory_order::release); }
+
+	private:
+		std::atomic<duration::rep> ticks{ 0 };
+	};
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+#include "RE/Skyrim.h"
+
+namespace Utils::Events
+{
+	template <class T>
+	class Registry;
+
+	/// <summary>
+	/// A typed subscriber to game events of type T. Subscribers are linked intrusively into the registry of their event type,
+	/// so they must outlive it (statics or globals). They are never unlinked, only disabled.
+	/// </summary>
+	template <class T>
+	class Subscriber
+	{
+	public:
+		using Callback = void (*)(const T&);
+
+		constexpr Subscriber(std::string_view name, Callback callback) :
+			name(name), callback(callback) {}
+
+		Subscriber(const Subscriber&) = delete;
+		Subscriber& operator=(const Subscriber&) = delete;
+
+		void SetEnabled(bool enable) { enabled.store(enable, std::memory_order_relaxed); }
+		[[nodiscard]] bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+		[[nodiscard]] std::string_view GetName() const { return name; }
+
+		// Only counted while the registry's counters are enabled
+		[[nodiscard]] std::uint64_t GetCalls() const { return calls.load(std::memory_order_relaxed); }
+		[[nodiscard]] std::uint64_t GetNanoseconds() const { return nanoseconds.load(std::memory_order_relaxed); }
+
+	private:
+		friend class Registry<T>;
+
+		std::string_view name;
+		Callback callback;
+		std::atomic<bool> enabled{ true };
+		std::atomic<std::uint64_t> calls{ 0 };
+		std::atomic<std::uint64_t> nanoseconds{ 0 };
+		std::atomic<Subscriber*> next{ nullptr };
+		bool linked{ false };
+	};
+
+	/// <summary>
+	/// The single game sink for events of type T. It fans every event out to the subscribers in registration order,
+	/// dispatching does not allocate or lock.
+	/// </summary>
+	template <class T>
+	class Registry final : public RE::BSTEventSink<T>
+	{
+	public:
+		static Registry& Get()
+		{
+			static Registry singleton;
+			return singleton;
+		}
+
+		/// <summary>
+		/// Links the subscriber into the registry. Can be called from any thread, subscribing twice is a no-op.
+		/// </summary>
+		void Subscribe(Subscriber<T>& subscriber)
+		{
+			std::scoped_lock lock(mutex);
+			if (subscriber.linked) {
+				return;
+			}
+			subscriber.linked = true;
+
+			// Publish the fully initialized node last, a concurrent dispatch either sees it or doesn't
+			if (tail) {
+				tail->next.store(&subscriber, std::memory_order_release);
+			} else {
+				head.store(&subscriber, std::memory_order_release);
+			}
+			tail = &subscriber;
+		}
+
+		// Per-subscriber call counts and timings, disabled by default
+		void SetCountersEnabled(bool enabled) { countersEnabled.store(enabled, std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Adds the registry sink to the given event source. The game ignores sinks that are already registered.
+		/// </summary>
+		void Attach(RE::BSTEventSource<T>* source)
+		{
+			if (source) {
+				source->AddEventSink(this);
+			}
+		}
+
+		RE::BSEventNotifyControl ProcessEvent(const T* a_event, [[maybe_unused]] RE::BSTEventSource<T>* a_eventSource) override
+		{
+			if (!a_event) {
+				return RE::BSEventNotifyControl::kContinue;
+			}
+
+			const bool counting = countersEnabled.load(std::memory_order_relaxed);
+			for (auto* subscriber = head.load(std::memory_order_acquire); subscriber; subscriber = subscriber->next.load(std::memory_order_acquire)) {
+				if (!subscriber->IsEnabled()) {
+					continue;
+				}
+
+				if (!counting) {
+					subscriber->callback(*a_event);
+					continue;
+				}
+
+				const auto start = std::chrono::steady_clock::now();
+				subscriber->callback(*a_event);
+				const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+				subscriber->calls.fetch_add(1, std::memory_order_relaxed);
+				subscriber->nanoseconds.fetch_add(elapsed.count(), std::memory_order_relaxed);
+			}
+			return RE::BSEventNotifyControl::kContinue;
+		}
+
+	private:
+		Registry() = default;
+
+		std::mutex mutex;
+		std::atomic<Subscriber<T>*> head{ nullptr };
+		Subscriber<T>* tail{ nullptr };  // Guarded by mutex
+		std::atomic<bool> countersEnabled{ false };
+	};
+
+	template <class T>
+	void Subscribe(Subscriber<T>& subscriber)
+	{
+		Registry<T>::Get().Subscribe(subscriber);
+	}
+}
@@ -0,0 +1,77 @@
+#include "utils/FrameClock.h"
+
+#include "utils/TimedWorker.h"
+
+#include <thread>
+
+namespace Utils
+{
+	namespace
+	{
+		// Trivially destructible, so workers can still unregister during static destruction
+		constinit FrameClock g_frameClock;
+	}
+
+	FrameClock& FrameClock::Get()
+	{
+		return g_frameClock;
+	}
+
+	void FrameClock::Tick(Clock::time_point now)
+	{
+		if (lastFrameStart != Clock::time_point{}) {
+			const auto delta = now - lastFrameStart;
+			if (delta > Clock::duration::zero() && delta < kMaxFrameGap) {
+				// Exponential moving average over roughly 8 frames
+				const auto period = framePeriod.load(std::memory_order_relaxed);
+				framePeriod.store(period == 0 ? delta.count() : period + (delta.count() - period) / 8, std::memory_order_relaxed);
+			}
+		}
+		lastFrameStart = now;
+
+		const auto frame = frameCount.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+		// Unregister waits while the sequence is odd, a worker this loop has loaded stays alive until it is done
+		tickSequence.fetch_add(1, std::memory_order_seq_cst);
+		for (const auto& slot : workers) {
+			if (auto* worker = slot.load(std::memory_order_seq_cst); worker && worker->IsFrameDue(frame)) {
+				worker->NotifyFrame();
+			}
+		}
+		tickSequence.fetch_add(1, std::memory_order_release);
+	}
+
+	bool FrameClock::Register(TimedWorker& worker)
+	{
+		for (const auto& slot : workers) {
+			if (slot.load(std::memory_order_relaxed) == &worker) {
+				return true;
+			}
+		}
+
+		for (auto& slot : workers) {
+			TimedWorker* expected = nullptr;
+			if (slot.compare_exchange_strong(expected, &worker, std::memory_order_acq_rel)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void FrameClock::Unregister(TimedWorker& worker)
+	{
+		for (auto& slot : workers) {
+			TimedWorker* expected = &worker;
+			slot.compare_exchange_strong(expected, nullptr, std::memory_order_seq_cst);
+		}
+
+		// A Tick that started after the slots were cleared can't see the worker anymore. One that is still running may have
+		// loaded it before, wait until that Tick is done.
+		const auto sequence = tickSequence.load(std::memory_order_seq_cst);
+		if (sequence % 2 != 0) {
+			while (tickSequence.load(std::memory_order_acquire) == sequence) {
+				std::this_thread::yield();
+			}
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/Clock.h"
+
+namespace Utils
+{
+	class TimedWorker;
+
+	/// <summary>
+	/// Counts game frames. Ticked once per frame from the main thread, it wakes frame-aligned workers right after the frame
+	/// they are due on, so their output lines up with the game's frame cadence instead of drifting against it.
+	/// </summary>
+	class FrameClock
+	{
+	public:
+		constexpr static std::size_t kMaxWorkers = 16;
+
+		[[nodiscard]] static FrameClock& Get();
+
+		/// <summary>
+		/// Starts a new frame. Must be called exactly once per frame.
+		/// </summary>
+		void Tick(Clock::time_point now);
+
+		[[nodiscard]] std::uint64_t FrameCount() const { return frameCount.load(std::memory_order_seq_cst); }
+
+		// Smoothed frame period, zero until two frames have been seen
+		[[nodiscard]] Clock::duration FramePeriod() const { return Clock::duration(framePeriod.load(std::memory_order_relaxed)); }
+
+		bool Register(TimedWorker& worker);
+
+		/// <summary>
+		/// Removes the worker and waits for a Tick that may still be notifying it, so the worker can be destroyed afterwards.
+		/// Must not be called from inside a Tick.
+		/// </summary>
+		void Unregister(TimedWorker& worker);
+
+	private:
+		// Longer gaps are loading screens or hitches and don't count towards the frame period
+		constexpr static auto kMaxFrameGap = std::chrono::milliseconds(100);
+
+		std::atomic<std::uint64_t> frameCount{ 0 };
+		std::atomic<Clock::duration::rep> framePeriod{ 0 };
+		Clock::time_point lastFrameStart{};  // Only touched by Tick
+		std::array<std::atomic<TimedWorker*>, kMaxWorkers> workers{};
+		std::atomic<std::uint64_t> tickSequence{ 0 };  // Odd while Tick is notifying workers
+	};
+}
@@ -1,8 +1,9 @@
 #include "utils/GameState.h"
 
-#include <cstring>
+#include <array>
 
 #include "RE/Skyrim.h"
+#include "SpellMetadata.h"
 
 namespace Utils
 {
@@ -34,14 +35,29 @@ namespace Utils
 
 	bool InvertVRInputForSpell(RE::SpellItem* spell)
 	{
-		if (!spell) {
+		// Runs for every controller event. Only concentration spells are inverted, so the casting type is read straight from the form.
+		if (!spell || spell->GetCastingType() != RE::MagicSystem::CastingType::kConcentration) {
 			return false;
 		}
 
-		bool invertInput = spell->GetCastingType() == RE::MagicSystem::CastingType::kConcentration;
-		if (invertInput && (std::strcmp(spell->GetName(), "Telekinesis") == 0)) {
-			invertInput = false;
+		// The exceptions come from the spell table, remembered for the spells in both hands so a lookup only happens when one changes
+		struct CachedSpell
+		{
+			const RE::SpellItem* spell{ nullptr };
+			bool invertInput{ false };
+		};
+		thread_local std::array<CachedSpell, 2> cache{};
+		thread_local std::size_t nextSlot{ 0 };
+
+		for (const auto& entry : cache) {
+			if (entry.spell == spell) {
+				return entry.invertInput;
+			}
 		}
-		return invertInput;
+
+		auto& entry = cache[nextSlot];
+		nextSlot = (nextSlot + 1) % cache.size();
+		entry = { .spell = spell, .invertInput = SpellMetadata::Get(spell).invertInput };
+		return entry.invertInput;
 	}
 }
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "SKSE/Logger.h"
+#include "utils/LogPipeline.h"
+
+#define ISPVR_LOG_TRACE(...) ISPVR_LOG_AT(spdlog::level::trace, SKSE::log::trace, __VA_ARGS__)
+#define ISPVR_LOG_DEBUG(...) ISPVR_LOG_AT(spdlog::level::debug, SKSE::log::debug, __VA_ARGS__)
+#define ISPVR_LOG_INFO(...) ISPVR_LOG_AT(spdlog::level::info, SKSE::log::info, __VA_ARGS__)
@@ -0,0 +1,59 @@
+#include "utils/LogPipeline.h"
+
+#include <string>
+
+#include <spdlog/async.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/sinks/base_sink.h>
+
+namespace Log
+{
+	namespace
+	{
+		/// <summary>
+		/// Front sink of the release logger. Records below warn go to the async logger, so the calling thread only enqueues them.
+		/// Warnings and errors are written to the file and flushed on the calling thread, so they are on disk even if the game
+		/// crashes right after. They can end up ahead of info records that are still queued.
+		/// </summary>
+		class SeveritySplitSink final : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+		{
+		public:
+			SeveritySplitSink(std::shared_ptr<spdlog::sinks::sink> file, std::shared_ptr<spdlog::async_logger> queued) :
+				file(std::move(file)), queued(std::move(queued)) {}
+
+		protected:
+			void sink_it_(const spdlog::details::log_msg& msg) override
+			{
+				if (msg.level < spdlog::level::warn) {
+					queued->log(msg.time, msg.source, msg.level, msg.payload);
+					return;
+				}
+				file->log(msg);
+				file->flush();
+			}
+
+			void flush_() override
+			{
+				queued->flush();
+				file->flush();
+			}
+
+			void set_pattern_(const std::string& pattern) override { file->set_pattern(pattern); }
+			void set_formatter_(std::unique_ptr<spdlog::formatter> formatter) override { file->set_formatter(std::move(formatter)); }
+
+		private:
+			std::shared_ptr<spdlog::sinks::sink> file;  // Thread safe, shared with the async logger
+			std::shared_ptr<spdlog::async_logger> queued;
+		};
+	}
+
+	std::shared_ptr<spdlog::logger> MakeReleaseLogger(std::shared_ptr<spdlog::sinks::sink> file, std::size_t queueSize)
+	{
+		spdlog::init_thread_pool(queueSize, 1);
+		auto queued = std::make_shared<spdlog::async_logger>("queued log", file, spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+		queued->set_level(spdlog::level::trace);
+		auto log = std::make_shared<spdlog::logger>("global log", std::make_shared<SeveritySplitSink>(std::move(file), std::move(queued)));
+		log->set_level(spdlog::level::info);
+		return log;
+	}
+}
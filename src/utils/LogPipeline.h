@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <spdlog/spdlog.h>
+
+// Compile-time log threshold, levels below it are stripped including their arguments.
+// Uses spdlog's numbering (0 = trace ... 6 = off) and can be overridden with the xmake option "log_level".
+#ifndef ISPVR_LOG_LEVEL
+#	ifdef NDEBUG
+#		define ISPVR_LOG_LEVEL SPDLOG_LEVEL_INFO
+#	else
+#		define ISPVR_LOG_LEVEL SPDLOG_LEVEL_TRACE
+#	endif
+#endif
+
+namespace Log
+{
+	constexpr bool IsCompiled(spdlog::level::level_enum level)
+	{
+		return static_cast<int>(level) >= ISPVR_LOG_LEVEL;
+	}
+
+	inline bool ShouldLog(spdlog::level::level_enum level)
+	{
+		const auto* log = spdlog::default_logger_raw();
+		return log && log->should_log(level);
+	}
+
+	/// <summary>
+	/// Builds the release logger on top of the given file sink. Below warn, threads only enqueue the formatted message and a single
+	/// background thread writes the file. If the queue is full the oldest of those records are dropped instead of blocking the
+	/// caller. Warnings and errors skip the queue and are written and flushed on the calling thread.
+	/// Starts spdlog's thread pool, so it must only be called once.
+	/// </summary>
+	std::shared_ptr<spdlog::logger> MakeReleaseLogger(std::shared_ptr<spdlog::sinks::sink> file, std::size_t queueSize = 8192);
+}
+
+// The arguments are only evaluated if the level is compiled in and enabled at runtime.
+// These are macros so the source location of the call site ends up in the log.
+#define ISPVR_LOG_AT(level, function, ...)                      \
+	do {                                                        \
+		if constexpr (::Log::IsCompiled(level)) {               \
+			if (::Log::ShouldLog(level)) {                      \
+				function(__VA_ARGS__);                          \
+			}                                                   \
+		}                                                       \
+	} while (false)
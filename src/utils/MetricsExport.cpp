@@ -0,0 +1,74 @@
+#include "utils/MetricsExport.h"
+
+#include <chrono>
+#include <memory>
+#include <new>
+
+#include <windows.h>
+
+#include "core/Metrics.h"
+#include "utils/TimedWorker.h"
+
+namespace Utils::MetricsExport
+{
+	namespace
+	{
+		class Publisher : public TimedWorker
+		{
+		public:
+			explicit Publisher(Metrics::SharedSnapshot* target) :
+				target(target)
+			{
+				minInterval.store(kPublishInterval, std::memory_order_relaxed);
+				Start();
+			}
+
+			constexpr static std::chrono::milliseconds kPublishInterval = std::chrono::milliseconds(250);
+
+		private:
+			void Work() override
+			{
+				Metrics::Collect(data);
+				data.publishedAtNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(clock.Now().time_since_epoch()).count();
+				Metrics::Publish(*target, data);
+			}
+
+			Metrics::SharedSnapshot* target;
+			Metrics::SnapshotData data;
+		};
+
+		std::unique_ptr<Publisher> g_publisher;
+	}
+
+	void Install()
+	{
+		if (g_publisher) {
+			return;
+		}
+
+		auto* mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(Metrics::SharedSnapshot), Metrics::kSharedMemoryName);
+		if (!mapping) {
+			logger::warn("Metrics: could not create shared memory segment (error {})", GetLastError());
+			return;
+		}
+
+		// The mapping stays open for the lifetime of the process
+		auto* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(Metrics::SharedSnapshot));
+		if (!view) {
+			logger::warn("Metrics: could not map shared memory segment (error {})", GetLastError());
+			CloseHandle(mapping);
+			return;
+		}
+
+		auto* snapshot = new (view) Metrics::SharedSnapshot{};
+		g_publisher = std::make_unique<Publisher>(snapshot);
+		logger::info("Metrics: publishing to {}", Metrics::kSharedMemoryName);
+	}
+
+	void Pause(bool paused)
+	{
+		if (g_publisher) {
+			g_publisher->Pause(paused);
+		}
+	}
+}
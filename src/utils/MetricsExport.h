@@ -0,0 +1,13 @@
+#pragma once
+
+namespace Utils::MetricsExport
+{
+	/// <summary>
+	/// Creates the shared memory segment and starts publishing metric snapshots into it a few times per second.
+	/// External tools open the segment by name and sample it without stopping the game.
+	/// </summary>
+	void Install();
+
+	// Parks the publisher, the last snapshot stays readable
+	void Pause(bool paused);
+}
@@ -11,6 +11,7 @@
 #include "utils/Input.h"
 #include "utils/MessageBox.h"
 #include "utils/GameState.h"
+#include "utils/LogPipeline.h"
 
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/msvc_sink.h>
@@ -140,13 +141,11 @@ Please update Haptic Skyrim VR to version 1.8.0 or higher! )",
 		auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path->string(), true);
 #endif
 
-		auto log = std::make_shared<spdlog::logger>("global log"s, std::move(sink));
-
 #ifndef NDEBUG
+		auto log = std::make_shared<spdlog::logger>("global log"s, std::move(sink));
 		log->set_level(spdlog::level::trace);
 #else
-		log->set_level(spdlog::level::info);
-		log->flush_on(spdlog::level::warn);
+		auto log = Log::MakeReleaseLogger(std::move(sink));
 #endif
 
 		spdlog::set_default_logger(std::move(log));
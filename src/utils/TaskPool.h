@@ -0,0 +1,100 @@
+#pragma once
+
+#include "SKSE/SKSE.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+namespace Utils
+{
+	/// <summary>
+	/// Fixed set of reusable SKSE task delegates that call a plain function with a small argument struct. Queueing a task only
+	/// claims a free slot, so worker threads can hand work to the game threads without allocating. If every slot is still in
+	/// flight the task is queued the regular (allocating) way instead.
+	/// </summary>
+	template <class Args, std::size_t Capacity = 32>
+	class TaskPool
+	{
+		static_assert(Capacity > 0 && Capacity <= 64, "Slots are tracked in a 64 bit mask");
+		static_assert(std::is_trivially_copyable_v<Args>, "Arguments are copied into the slot");
+
+	public:
+		using Function = void (*)(const Args&);
+
+		explicit TaskPool(Function function) :
+			function(function)
+		{
+			for (auto& slot : slots) {
+				slot.pool = this;
+			}
+		}
+
+		TaskPool(const TaskPool&) = delete;
+		TaskPool& operator=(const TaskPool&) = delete;
+
+		void AddTask(const Args& args) { Queue(args, false); }
+		void AddUITask(const Args& args) { Queue(args, true); }
+
+		// Number of tasks that found no free slot and had to allocate
+		[[nodiscard]] std::uint64_t Overflows() const { return overflows.load(std::memory_order_relaxed); }
+
+	private:
+		// Both SKSE delegate interfaces only need Run and Dispose, one slot type serves the task and the UI queue
+		class Slot final : public SKSE::TaskDelegate, public SKSE::UIDelegate_v1
+		{
+		public:
+			void Run() override { pool->function(args); }
+			void Dispose() override { pool->Release(this); }
+
+			TaskPool* pool{ nullptr };
+			Args args{};
+		};
+
+		constexpr static std::uint64_t kAllSlots = Capacity == 64 ? ~0ull : (1ull << Capacity) - 1;
+
+		void Queue(const Args& args, bool uiTask)
+		{
+			auto* tasks = SKSE::GetTaskInterface();
+			auto* slot = Acquire();
+			if (!slot) {
+				overflows.fetch_add(1, std::memory_order_relaxed);
+				auto fallback = [fn = function, args] { fn(args); };
+				uiTask ? tasks->AddUITask(fallback) : tasks->AddTask(fallback);
+				return;
+			}
+
+			slot->args = args;
+			if (uiTask) {
+				tasks->AddUITask(static_cast<SKSE::UIDelegate_v1*>(slot));
+			} else {
+				tasks->AddTask(static_cast<SKSE::TaskDelegate*>(slot));
+			}
+		}
+
+		Slot* Acquire()
+		{
+			auto used = inUse.load(std::memory_order_relaxed);
+			while (const auto free = ~used & kAllSlots) {
+				const auto index = std::countr_zero(free);
+				if (inUse.compare_exchange_weak(used, used | (1ull << index), std::memory_order_acquire, std::memory_order_relaxed)) {
+					return &slots[index];
+				}
+			}
+			return nullptr;
+		}
+
+		void Release(Slot* slot)
+		{
+			const auto index = static_cast<std::size_t>(slot - slots.data());
+			inUse.fetch_and(~(1ull << index), std::memory_order_release);
+		}
+
+		Function function;
+		std::array<Slot, Capacity> slots{};
+		std::atomic<std::uint64_t> inUse{ 0 };
+		std::atomic<std::uint64_t> overflows{ 0 };
+	};
+}
@@ -1,14 +1,19 @@
 #include "utils/TimedWorker.h"
 
+#include <algorithm>
+
 namespace Utils
 {
-	TimedWorker::TimedWorker() :
-		minInterval(std::chrono::milliseconds(5)),
+	TimedWorker::TimedWorker(Clock& clock) :
+		minInterval(kIntervalFloor),
+		clock(clock),
 		running(false)
 	{}
 
 	TimedWorker::~TimedWorker()
 	{
+		// Leave the frame clock first, so a Tick on the main thread stops notifying this worker before it is torn down
+		SetFrameClock(nullptr);
 		Stop();
 	}
 
@@ -24,11 +29,17 @@ namespace Utils
 		}
 
 		worker = std::thread(&TimedWorker::Run, this);
+		threadsCreated.fetch_add(1, std::memory_order::relaxed);
 	}
 
 	void TimedWorker::Stop()
 	{
-		const bool wasRunning = running.exchange(false, std::memory_order::relaxed);
+		bool wasRunning;
+		{
+			// Hold the lock so the worker can't miss the notification between checking the flag and going to sleep
+			std::lock_guard lock(mutex);
+			wasRunning = running.exchange(false, std::memory_order::relaxed);
+		}
 		if (!wasRunning && !worker.joinable()) {
 			return;
 		}
@@ -43,26 +54,115 @@ namespace Utils
 
 	void TimedWorker::Notify()
 	{
+		{
+			// Set under the lock and checked by the worker before it sleeps, so a notification that lands while Work() runs isn't lost
+			std::lock_guard lock(mutex);
+			notified = true;
+		}
+		cv.notify_one();
+	}
+
+	void TimedWorker::Pause(bool paused)
+	{
+		{
+			std::lock_guard lock(mutex);
+			if (this->paused.exchange(paused, std::memory_order::relaxed) == paused) {
+				return;
+			}
+		}
+
 		cv.notify_one();
 	}
 
+	void TimedWorker::NotifyFrame()
+	{
+		{
+			std::lock_guard lock(mutex);
+		}
+		cv.notify_one();
+	}
+
+	void TimedWorker::SetFrameClock(FrameClock* frames)
+	{
+		auto* previous = frameClock.exchange(frames, std::memory_order_acq_rel);
+		if (previous == frames) {
+			return;
+		}
+
+		if (previous) {
+			previous->Unregister(*this);
+		}
+		if (frames && !frames->Register(*this)) {
+			frameClock.store(nullptr, std::memory_order_release);
+			return;
+		}
+
+		// Reschedule with the new mode
+		Notify();
+	}
+
+	std::uint32_t TimedWorker::ThreadsCreated()
+	{
+		return threadsCreated.load(std::memory_order::relaxed);
+	}
+
+	std::optional<Clock::time_point> TimedWorker::RunOnce()
+	{
+		Work();
+		return NextWakeup(clock.Now());
+	}
+
+	std::optional<Clock::time_point> TimedWorker::NextWakeup(Clock::time_point from) const
+	{
+		const auto interval = minInterval.load(std::memory_order::relaxed);
+		if (interval.count() <= 0) {
+			return std::nullopt;
+		}
+		return from + std::max(interval, kIntervalFloor);
+	}
+
+	void TimedWorker::WaitForFrame(std::unique_lock<std::mutex>& lock, FrameClock& frames)
+	{
+		const auto interval = std::chrono::duration_cast<Clock::duration>(std::max(minInterval.load(std::memory_order::relaxed), kIntervalFloor));
+		const auto period = frames.FramePeriod();
+
+		// Frames stopped or haven't been measured yet, fall back to the interval
+		if (period <= Clock::duration::zero()) {
+			cv.wait_until(lock, clock.Now() + interval, [this] { return ShouldWake(); });
+			return;
+		}
+
+		const auto frameCount = std::max<Clock::duration::rep>(1, (interval + period / 2) / period);
+		const auto target = frames.FrameCount() + static_cast<std::uint64_t>(frameCount);
+
+		// Publish the target before re-checking the frame count, FrameClock::Tick does the opposite. Either the tick sees the
+		// target and notifies once this thread waits, or this thread sees the new frame and doesn't wait at all.
+		wakeFrame.store(target, std::memory_order_seq_cst);
+		if (frames.FrameCount() < target) {
+			// The timeout only matters if frames stop coming
+			cv.wait_until(lock, clock.Now() + std::max(interval * 2, std::chrono::duration_cast<Clock::duration>(kFrameFallback)), [&] {
+				return ShouldWake() || frames.FrameCount() >= target;
+			});
+		}
+		wakeFrame.store(0, std::memory_order_relaxed);
+	}
+
 	void TimedWorker::Run()
 	{
+		// Timed waits need a clock that follows real time. Workers driven by a manual clock are stepped via RunOnce() instead.
+		const bool realTime = clock.IsRealTime();
+
 		while (running.load(std::memory_order::relaxed)) {
-			Work();
-
-			auto interval = minInterval.load(std::memory_order::relaxed);
-			auto now = std::chrono::steady_clock::now();
-			bool waitForNotifyOnly = interval.count() <= 0;
-			std::chrono::steady_clock::time_point nextLoop = now;
-
-			if (!waitForNotifyOnly) {
-				if (interval.count() < 5) {
-					interval = std::chrono::milliseconds(5);
-				}
-				nextLoop = now + interval;
+			if (paused.load(std::memory_order::relaxed)) {
+				std::unique_lock<std::mutex> lock(mutex);
+				cv.wait(lock, [this] {
+					return !paused.load(std::memory_order::relaxed) || !running.load(std::memory_order::relaxed);
+				});
+				continue;
 			}
 
+			const auto nextLoop = RunOnce();
+
 			if (!running.load(std::memory_order::relaxed)) {
 				break;
 			}
@@ -72,29 +172,19 @@ namespace Utils
 				break;
 			}
 
-			auto updatedInterval = minInterval.load(std::memory_order::relaxed);
-			const bool updatedWaitForNotifyOnly = updatedInterval.count() <= 0;
+			// minInterval may have been changed from another thread since the work iteration finished.
+			const auto updatedLoop = NextWakeup(clock.Now());
 
-			if (!waitForNotifyOnly && !updatedWaitForNotifyOnly) {
-				cv.wait_until(lock, nextLoop);
-				continue;
-			}
-
-			if (!waitForNotifyOnly && updatedWaitForNotifyOnly) {
-				cv.wait(lock);
-				continue;
-			}
-
-			if (waitForNotifyOnly && !updatedWaitForNotifyOnly) {
-				if (updatedInterval.count() < 5) {
-					updatedInterval = std::chrono::milliseconds(5);
-				}
-				const auto adjustedLoop = std::chrono::steady_clock::now() + updatedInterval;
-				cv.wait_until(lock, adjustedLoop);
-				continue;
+			if (!updatedLoop || !realTime) {
+				cv.wait(lock, [this] { return ShouldWake(); });
+			} else if (auto* frames = frameClock.load(std::memory_order_acquire)) {
+				WaitForFrame(lock, *frames);
+			} else {
+				cv.wait_until(lock, nextLoop ? *nextLoop : *updatedLoop, [this] { return ShouldWake(); });
 			}
 
-			cv.wait(lock);
+			// Notifications up to here are handled by the next work iteration
+			notified = false;
 		}
 	}
 }
@@ -3,32 +3,92 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
+#include <optional>
 #include <thread>
 
+#include "utils/Clock.h"
+#include "utils/FrameClock.h"
+
 namespace Utils
 {
 	class TimedWorker
 	{
 	public:
-		TimedWorker();
+		explicit TimedWorker(Clock& clock = Clock::Steady());
 		virtual ~TimedWorker();
 
 		void Start();
 		void Stop();
 		void Notify();
 
+		/// <summary>
+		/// Parks the worker without stopping its thread. A paused worker sleeps until it is resumed, resuming does not allocate.
+		/// </summary>
+		void Pause(bool paused);
+
+		// Number of worker threads created since the plugin was loaded.
+		[[nodiscard]] static std::uint32_t ThreadsCreated();
+
+		/// <summary>
+		/// Runs a single work iteration on the calling thread instead of the worker thread.
+		/// Returns the time point at which the worker wants to run again, or nothing if it only waits for Notify().
+		/// </summary>
+		std::optional<Clock::time_point> RunOnce();
+
+		/// <summary>
+		/// Aligns the wakeups of a running worker to the frames of the given clock, nullptr returns to free running.
+		/// In frame mode minInterval is rounded to whole frames (at least one) and the worker runs right after the frame it is due on.
+		/// If frames stop coming (loading screens) the worker falls back to timed wakeups.
+		/// </summary>
+		void SetFrameClock(FrameClock* frames);
+
 		std::atomic<std::chrono::milliseconds> minInterval;
 
+		// Shortest interval the worker will ever sleep for, lower values are clamped.
+		constexpr static std::chrono::milliseconds kIntervalFloor = std::chrono::milliseconds(5);
+
+		// Longest a frame-aligned worker waits for its frame before running anyway
+		constexpr static std::chrono::milliseconds kFrameFallback = std::chrono::milliseconds(100);
+
 	protected:
 		virtual void Work() = 0;
 
+		Clock& clock;
+
 	private:
+		friend class FrameClock;
+
+		[[nodiscard]] bool IsFrameDue(std::uint64_t frame) const
+		{
+			const auto due = wakeFrame.load(std::memory_order_seq_cst);
+			return due != 0 && frame >= due;
+		}
+
+		// Wakes the worker for its frame. Passing through the lock ensures the worker is already waiting.
+		void NotifyFrame();
+
+		// Must be called with the lock held
+		[[nodiscard]] bool ShouldWake() const
+		{
+			return notified || paused.load(std::memory_order::relaxed) || !running.load(std::memory_order::relaxed);
+		}
+
+		void WaitForFrame(std::unique_lock<std::mutex>& lock, FrameClock& frames);
 		void Run();
+		std::optional<Clock::time_point> NextWakeup(Clock::time_point from) const;
 
 		std::mutex mutex;
 		std::condition_variable cv;
 		std::thread worker;
 		std::atomic<bool> running;
+		std::atomic<bool> paused{ false };
+		bool notified{ false };  // Guarded by mutex
+
+		std::atomic<FrameClock*> frameClock{ nullptr };
+		std::atomic<std::uint64_t> wakeFrame{ 0 };  // Frame after which the worker wants to run, 0 if it doesn't wait for a frame
+
+		inline static std::atomic<std::uint32_t> threadsCreated{ 0 };
 	};
 }
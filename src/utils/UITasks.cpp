@@ -0,0 +1,39 @@
+#include "utils/UITasks.h"
+
+#include "SKSE/SKSE.h"
+#include "utils/TaskPool.h"
+
+#include <atomic>
+
+namespace Utils::UITasks
+{
+	namespace
+	{
+		::Tasks::Scheduler g_scheduler;
+		std::atomic_bool g_tickQueued{ false };
+
+		struct TickArgs
+		{};
+
+		// One tick is queued at a time, the second slot covers a new tick being queued before the running one released its slot
+		Utils::TaskPool<TickArgs, 2> g_tickTasks{ [](const TickArgs&) {
+			g_tickQueued.store(false, std::memory_order_relaxed);
+			g_scheduler.Tick();
+		} };
+	}
+
+	void Spawn(::Tasks::Task task)
+	{
+		g_scheduler.Spawn(std::move(task));
+	}
+
+	void OnFrame()
+	{
+		if (!g_scheduler.HasPending() || g_tickQueued.exchange(true, std::memory_order_relaxed)) {
+			return;
+		}
+
+		// Ticks are requested from the per-frame hook instead of re-queueing themselves, SKSE drains the UI queue until it is empty.
+		g_tickTasks.AddUITask({});
+	}
+}
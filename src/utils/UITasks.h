@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+
+#include "CasterStateTracker.h"
+#include "core/FrameTasks.h"
+
+namespace Utils::UITasks
+{
+	/// <summary>
+	/// Spawns a task that is stepped on the UI thread, at most once per frame.
+	/// </summary>
+	void Spawn(::Tasks::Task task);
+
+	/// <summary>
+	/// Queues a scheduler tick on the UI thread if tasks are pending. Must be called once per frame from the main thread.
+	/// </summary>
+	void OnFrame();
+
+	inline auto NextUIFrame() { return ::Tasks::NextFrame(); }
+
+	inline auto Delay(std::chrono::milliseconds delay) { return ::Tasks::Delay(delay); }
+
+	/// <summary>
+	/// Waits until the caster of the given physical hand is in the given state. Resumes with false if it timed out.
+	/// </summary>
+	inline auto CasterState(bool physicalLeft, CasterStateTracker::ActualState state, std::chrono::milliseconds timeout = std::chrono::milliseconds(1000))
+	{
+		auto* handState = physicalLeft ? &CasterStateTracker::lastLeftHandState : &CasterStateTracker::lastRightHandState;
+		return ::Tasks::WaitUntil(
+			[handState, state] { return handState->load(std::memory_order_relaxed) == state; },
+			timeout);
+	}
+
+	/// <summary>
+	/// Waits until the casters of both hands are in the given state, with one timeout for both. Resumes with false if it timed out.
+	/// </summary>
+	inline auto CasterStates(CasterStateTracker::ActualState state, std::chrono::milliseconds timeout = std::chrono::milliseconds(1000))
+	{
+		return ::Tasks::WaitUntil(
+			[state] {
+				return CasterStateTracker::lastLeftHandState.load(std::memory_order_relaxed) == state
+					&& CasterStateTracker::lastRightHandState.load(std::memory_order_relaxed) == state;
+			},
+			timeout);
+	}
+}
@@ -0,0 +1,451 @@
+// Microbenchmarks for the per-frame and per-event paths of the core. Every benchmark has a time and an allocation budget per
+// operation, the run fails if any is exceeded. The core is built into this binary with allocation counting.
+//
+// Usage: ispvr_bench [--filter TEXT] [--budget-scale X]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <spdlog/sinks/basic_file_sink.h>
+
+#include "api/CasterStateInterface001.h"
+#include "core/AllocAudit.h"
+#include "core/ConfigCodec.h"
+#include "core/DispatchStateMachine.h"
+#include "core/FlightRecorder.h"
+#include "core/FrameTasks.h"
+#include "core/HapticFeed.h"
+#include "core/HapticMixer.h"
+#include "core/Metrics.h"
+#include "core/SeqLock.h"
+#include "core/SpellTable.h"
+#include "utils/Clock.h"
+#include "utils/FrameClock.h"
+#include "utils/LogPipeline.h"
+#include "utils/TimedWorker.h"
+
+#ifndef ISPVR_ALLOC_AUDIT
+#	error "ispvr_bench counts allocations, build it with ISPVR_ALLOC_AUDIT"
+#endif
+
+namespace
+{
+	using namespace std::chrono_literals;
+	using CasterStateTracker::ActualState;
+
+	// Results are folded into this so the optimizer can't drop the measured work
+	volatile std::uint64_t g_sink = 0;
+
+	struct Benchmark
+	{
+		const char* name;
+		double budgetNanoseconds;  // Per operation
+		double budgetAllocations;  // Per operation
+		std::function<void(std::uint64_t iterations)> run;
+	};
+
+	struct Measurement
+	{
+		double nanoseconds;
+		double allocations;
+	};
+
+	// Stand-in for HandHaptics: a mixer drained by its own worker thread
+	class MixerWorker : public Utils::TimedWorker
+	{
+	public:
+		MixerWorker()
+		{
+			channel = mixer.AddChannel(0, 1.0f);
+			minInterval.store(0ms, std::memory_order::relaxed);
+			Start();
+		}
+
+		~MixerWorker() override
+		{
+			Stop();
+		}
+
+		void Schedule(const Haptics::HapticEvent& event)
+		{
+			if (mixer.Schedule(channel, event)) {
+				Notify();
+			}
+		}
+
+	private:
+		void Work() override
+		{
+			minInterval.store(mixer.Advance(std::chrono::steady_clock::now()).nextInterval, std::memory_order::relaxed);
+		}
+
+		Haptics::HapticMixer mixer;
+		int channel{ -1 };
+	};
+
+	// Worker that only waits, to measure what parking and restarting costs
+	class IdleWorker : public Utils::TimedWorker
+	{
+	public:
+		IdleWorker()
+		{
+			minInterval.store(0ms, std::memory_order::relaxed);
+			Start();
+		}
+
+		~IdleWorker() override
+		{
+			Stop();
+		}
+
+	private:
+		void Work() override {}
+	};
+
+	// What the spell haptics do with a state change, roughly
+	Haptics::HapticEvent EventFor(ActualState state)
+	{
+		return state == ActualState::kIdle ? Haptics::HapticEvent{} : Haptics::HapticEvent{ .pulseInterval = 100, .interruptPulse = true };
+	}
+
+	// Stand-in for the spell haptics feed: the listener only posts, the worker schedules on the mixer
+	class FeedWorker : public Utils::TimedWorker
+	{
+	public:
+		explicit FeedWorker(MixerWorker& haptics) :
+			haptics(haptics)
+		{
+			minInterval.store(0ms, std::memory_order::relaxed);
+			Start();
+		}
+
+		~FeedWorker() override
+		{
+			Stop();
+		}
+
+		void Post(ActualState previousState, ActualState currentState)
+		{
+			if (mailbox.PostState(true, previousState, currentState)) {
+				Notify();
+			}
+		}
+
+	private:
+		void Work() override
+		{
+			if (const auto update = mailbox.Take(true); update && update->hasState) {
+				haptics.Schedule(EventFor(update->currentState));
+			}
+		}
+
+		MixerWorker& haptics;
+		Haptics::FeedMailbox mailbox;
+	};
+
+	// Caster state listeners are std::functions called from the caster update hook
+	using StateListener = std::function<void(ActualState previousState, ActualState currentState)>;
+
+	void RunCasterEvents(const StateListener& listener, std::uint64_t n)
+	{
+		for (std::uint64_t i = 0; i < n; ++i) {
+			const bool idle = (i & 1) != 0;
+			listener(idle ? ActualState::kCharging : ActualState::kIdle, idle ? ActualState::kIdle : ActualState::kCharging);
+		}
+	}
+
+#ifdef _WIN32
+	constexpr const char* kNullDevice = "NUL";
+#else
+	constexpr const char* kNullDevice = "/dev/null";
+#endif
+
+	std::shared_ptr<spdlog::logger> WithPattern(std::shared_ptr<spdlog::logger> log)
+	{
+		log->set_pattern("%s(%#): [%^%l%$] %v");
+		return log;
+	}
+
+	// Makes the logger the default one. Only the first, unmeasured run of a benchmark registers it, later runs don't allocate.
+	void UseLogger(const std::shared_ptr<spdlog::logger>& log)
+	{
+		if (spdlog::default_logger_raw() != log.get()) {
+			spdlog::set_default_logger(log);
+		}
+	}
+
+	// A typical hot path log call, like the dispatcher's trace of an injected attack event
+	template <spdlog::level::level_enum Level>
+	void LogInjection(std::uint64_t i)
+	{
+		ISPVR_LOG_AT(Level, spdlog::log, Level, "{} hand {} {}", (i & 1) ? "Main" : "Off", (i & 2) ? "press" : "unpress", i);
+	}
+
+	constexpr auto kTargetBatchTime = 20ms;
+	constexpr int kBatches = 5;
+
+	Measurement Measure(const Benchmark& benchmark, AllocAudit::Site& site)
+	{
+		using Steady = std::chrono::steady_clock;
+
+		// Warm up and find a batch size that takes about kTargetBatchTime
+		std::uint64_t iterations = 1;
+		while (true) {
+			const auto start = Steady::now();
+			benchmark.run(iterations);
+			if (Steady::now() - start >= kTargetBatchTime / 4 || iterations >= (1ull << 30)) {
+				break;
+			}
+			iterations *= 4;
+		}
+
+		// Best batch, noise from other processes only ever makes a batch slower
+		double best = 0.0;
+		const auto allocationsBefore = site.allocations.load(std::memory_order_relaxed);
+		for (int batch = 0; batch < kBatches; ++batch) {
+			const AllocAudit::Scope scope(site);
+			const auto start = Steady::now();
+			benchmark.run(iterations);
+			const auto elapsed = std::chrono::duration<double, std::nano>(Steady::now() - start).count() / static_cast<double>(iterations);
+			best = batch == 0 ? elapsed : std::min(best, elapsed);
+		}
+		const auto allocations = site.allocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+		return { best, static_cast<double>(allocations) / static_cast<double>(iterations * kBatches) };
+	}
+
+	std::vector<Benchmark> MakeBenchmarks()
+	{
+		std::vector<Benchmark> benchmarks;
+
+		benchmarks.push_back({ "dispatch step, converged", 100.0, 0.0, [](std::uint64_t n) {
+			static InputDispatcher::DispatchStateMachine machine(Utils::Clock::time_point{});
+			const auto now = Utils::Clock::time_point{};
+			for (std::uint64_t i = 0; i < n; ++i) {
+				g_sink = g_sink + machine.Step(ActualState::kIdle, now).sendInput;
+			}
+		} });
+
+		benchmarks.push_back({ "dispatch declare and step", 200.0, 0.0, [](std::uint64_t n) {
+			static InputDispatcher::DispatchStateMachine machine(Utils::Clock::time_point{});
+			auto now = Utils::Clock::time_point{};
+			for (std::uint64_t i = 0; i < n; ++i) {
+				now += 1ms;
+				machine.Declare((i & 1) != 0);
+				g_sink = g_sink + machine.Step(ActualState::kIdle, now).sendInput;
+			}
+		} });
+
+		benchmarks.push_back({ "injection gate admit and run", 100.0, 0.0, [](std::uint64_t n) {
+			static InputDispatcher::InjectionGate gate;
+			for (std::uint64_t i = 0; i < n; ++i) {
+				if (gate.Admit((i & 1) != 0) == InputDispatcher::InjectionGate::Admission::kQueue) {
+					gate.OnRun();
+				}
+			}
+		} });
+
+		benchmarks.push_back({ "haptic mixer schedule and advance", 250.0, 0.0, [](std::uint64_t n) {
+			static Haptics::HapticMixer mixer;
+			static const int channel = mixer.AddChannel(0, 1.0f);
+			auto now = std::chrono::steady_clock::time_point{};
+			for (std::uint64_t i = 0; i < n; ++i) {
+				now += 10ms;
+				mixer.Schedule(channel, { .pulseInterval = 20, .pulseStrength = 0.5f, .pulses = 1 });
+				g_sink = g_sink + static_cast<std::uint64_t>(mixer.Advance(now).pulseStrength > 0.0f);
+			}
+		} });
+
+		// Main thread time of a caster state event per delivery policy, the haptics are scheduled inline or posted to a feed worker
+		benchmarks.push_back({ "caster event, inline haptics", 1000.0, 0.0, [](std::uint64_t n) {
+			static MixerWorker haptics;
+			static const StateListener listener = [](ActualState, ActualState currentState) {
+				haptics.Schedule(EventFor(currentState));
+			};
+			RunCasterEvents(listener, n);
+		} });
+
+		benchmarks.push_back({ "caster event, queued haptics", 100.0, 0.0, [](std::uint64_t n) {
+			static MixerWorker haptics;
+			static FeedWorker feed(haptics);
+			static const StateListener listener = [](ActualState previousState, ActualState currentState) {
+				feed.Post(previousState, currentState);
+			};
+			RunCasterEvents(listener, n);
+		} });
+
+		// Blocking menus park the workers, before that they were stopped and started with a new thread every time
+		benchmarks.push_back({ "worker pause and resume", 2000.0, 0.0, [](std::uint64_t n) {
+			static IdleWorker worker;
+			for (std::uint64_t i = 0; i < n; ++i) {
+				worker.Pause(true);
+				worker.Pause(false);
+			}
+		} });
+
+		benchmarks.push_back({ "worker stop and start", 100000.0, 1.0, [](std::uint64_t n) {
+			static IdleWorker worker;
+			for (std::uint64_t i = 0; i < n; ++i) {
+				worker.Stop();
+				worker.Start();
+			}
+		} });
+
+		// Per call cost of logging on a hot thread with the release logger, and with the synchronous file logger it replaced
+		benchmarks.push_back({ "log call below the level", 20.0, 0.0, [](std::uint64_t n) {
+			static const auto log = WithPattern(Log::MakeReleaseLogger(std::make_shared<spdlog::sinks::basic_file_sink_mt>(kNullDevice)));
+			UseLogger(log);
+			for (std::uint64_t i = 0; i < n; ++i) {
+				LogInjection<spdlog::level::debug>(i);
+			}
+		} });
+
+		benchmarks.push_back({ "log call, queued", 1000.0, 0.0, [](std::uint64_t n) {
+			static const auto log = WithPattern(Log::MakeReleaseLogger(std::make_shared<spdlog::sinks::basic_file_sink_mt>(kNullDevice)));
+			UseLogger(log);
+			for (std::uint64_t i = 0; i < n; ++i) {
+				LogInjection<spdlog::level::info>(i);
+			}
+		} });
+
+		benchmarks.push_back({ "log call, synchronous file", 2000.0, 0.0, [](std::uint64_t n) {
+			static const auto log = WithPattern(std::make_shared<spdlog::logger>("sync log", std::make_shared<spdlog::sinks::basic_file_sink_mt>(kNullDevice)));
+			UseLogger(log);
+			for (std::uint64_t i = 0; i < n; ++i) {
+				LogInjection<spdlog::level::info>(i);
+			}
+		} });
+
+		benchmarks.push_back({ "metrics increment", 50.0, 0.0, [](std::uint64_t n) {
+			for (std::uint64_t i = 0; i < n; ++i) {
+				Metrics::Increment(Metrics::Counter::kCasterEvents);
+			}
+		} });
+
+		benchmarks.push_back({ "metrics record", 50.0, 0.0, [](std::uint64_t n) {
+			for (std::uint64_t i = 0; i < n; ++i) {
+				Metrics::Record(Metrics::Histogram::kCasterHookNanoseconds, i);
+			}
+		} });
+
+		benchmarks.push_back({ "metrics collect and publish", 5000.0, 0.0, [](std::uint64_t n) {
+			static Metrics::SharedSnapshot shared;
+			static Metrics::SnapshotData data;
+			for (std::uint64_t i = 0; i < n; ++i) {
+				Metrics::Collect(data);
+				Metrics::Publish(shared, data);
+			}
+		} });
+
+		benchmarks.push_back({ "caster snapshot write", 100.0, 0.0, [](std::uint64_t n) {
+			static Utils::SeqLock<ISPVRApi::CasterStateSnapshot> snapshot;
+			ISPVRApi::CasterStateSnapshot value{};
+			for (std::uint64_t i = 0; i < n; ++i) {
+				value.frame = i;
+				snapshot.Write(value);
+			}
+		} });
+
+		benchmarks.push_back({ "caster snapshot read", 100.0, 0.0, [](std::uint64_t n) {
+			static Utils::SeqLock<ISPVRApi::CasterStateSnapshot> snapshot;
+			ISPVRApi::CasterStateSnapshot value{};
+			for (std::uint64_t i = 0; i < n; ++i) {
+				g_sink = g_sink + snapshot.Read(value);
+			}
+		} });
+
+		benchmarks.push_back({ "flight recorder record", 100.0, 0.0, [](std::uint64_t n) {
+			static Recorder::FlightRecorder recorder(0);
+			for (std::uint64_t i = 0; i < n; ++i) {
+				recorder.Record(Recorder::RecordType::kDecision, 1, 2, static_cast<std::uint32_t>(i));
+			}
+		} });
+
+		benchmarks.push_back({ "spell table find", 150.0, 0.0, [](std::uint64_t n) {
+			static const auto table = [] {
+				std::vector<Spells::SpellSource> sources(4096);
+				for (std::uint32_t i = 0; i < sources.size(); ++i) {
+					sources[i].formID = 0x01000000 + i * 7;
+				}
+				return Spells::SpellTable::Build(sources);
+			}();
+			for (std::uint64_t i = 0; i < n; ++i) {
+				g_sink = g_sink + (table.Find(0x01000000 + static_cast<std::uint32_t>(i % 4096) * 7) != nullptr);
+			}
+		} });
+
+		benchmarks.push_back({ "frame clock tick", 200.0, 0.0, [](std::uint64_t n) {
+			static Utils::FrameClock frames;
+			auto now = Utils::Clock::time_point{};
+			for (std::uint64_t i = 0; i < n; ++i) {
+				now += 11ms;
+				frames.Tick(now);
+			}
+		} });
+
+		benchmarks.push_back({ "frame task scheduler tick, idle", 100.0, 0.0, [](std::uint64_t n) {
+			static Tasks::Scheduler scheduler;
+			for (std::uint64_t i = 0; i < n; ++i) {
+				g_sink = g_sink + scheduler.Tick();
+			}
+		} });
+
+		benchmarks.push_back({ "config codec parse float", 1000.0, 0.0, [](std::uint64_t n) {
+			for (std::uint64_t i = 0; i < n; ++i) {
+				g_sink = g_sink + Config::Codec::DeserializeValue(Config::Type::kFloat, "0.75").has_value();
+			}
+		} });
+
+		return benchmarks;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string_view filter;
+	double budgetScale = 1.0;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			filter = argv[++i];
+		} else if (std::strcmp(argv[i], "--budget-scale") == 0 && i + 1 < argc) {
+			budgetScale = std::max(std::strtod(argv[++i], nullptr), 0.0);
+		} else {
+			std::fprintf(stderr, "Usage: %s [--filter TEXT] [--budget-scale X]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	const auto benchmarks = MakeBenchmarks();
+	std::deque<AllocAudit::Site> sites;  // Sites register themselves and must not move
+	int failures = 0;
+
+	std::printf("%-36s %12s %12s %10s %10s\n", "benchmark", "ns/op", "budget", "allocs/op", "budget");
+	for (const auto& benchmark : benchmarks) {
+		if (!filter.empty() && std::string_view(benchmark.name).find(filter) == std::string_view::npos) {
+			continue;
+		}
+
+		const auto result = Measure(benchmark, sites.emplace_back(benchmark.name));
+		const double timeBudget = benchmark.budgetNanoseconds * budgetScale;
+		const bool failed = result.nanoseconds > timeBudget || result.allocations > benchmark.budgetAllocations;
+		failures += failed ? 1 : 0;
+
+		std::printf("%-36s %12.1f %12.1f %10.3f %10.3f%s\n", benchmark.name, result.nanoseconds, timeBudget, result.allocations,
+			benchmark.budgetAllocations, failed ? "  OVER BUDGET" : "");
+	}
+
+	if (failures > 0) {
+		std::printf("%d benchmark(s) over budget\n", failures);
+		return 1;
+	}
+	return 0;
+}
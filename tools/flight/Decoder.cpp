@@ -0,0 +1,175 @@
+// Prints flight recorder dumps as a timeline. The plugin writes them next to its log when a hand gets stuck
+// (ImmersiveSpellcastingVR_flight_<hand>_<n>.bin), times are relative to the moment of the dump.
+//
+// Usage: ispvr_flight_decoder [--csv] FILE...
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "core/CasterState.h"
+#include "core/FlightRecorder.h"
+
+namespace
+{
+	using CasterStateTracker::ActualState;
+	using Recorder::RecordType;
+
+	const char* StateName(int state)
+	{
+		switch (static_cast<ActualState>(state)) {
+		case ActualState::kUnknown:
+			return "unknown";
+		case ActualState::kIdle:
+			return "idle";
+		case ActualState::kStart:
+			return "start";
+		case ActualState::kCharging:
+			return "charging";
+		case ActualState::kHolding:
+			return "holding";
+		case ActualState::kReleasing:
+			return "releasing";
+		case ActualState::kChargingUnk:
+			return "charging (unk)";
+		case ActualState::kCasting:
+			return "casting";
+		default:
+			return "other";
+		}
+	}
+
+	// States are recorded shifted by one so kUnknown fits into a byte
+	const char* RecordedStateName(std::uint8_t value)
+	{
+		return StateName(static_cast<int>(value) - 1);
+	}
+
+	const char* TypeName(RecordType type)
+	{
+		switch (type) {
+		case RecordType::kGrip:
+			return "grip";
+		case RecordType::kDeclared:
+			return "declared";
+		case RecordType::kInjected:
+			return "injected";
+		case RecordType::kCasterState:
+			return "caster";
+		case RecordType::kDecision:
+			return "decision";
+		case RecordType::kAnomaly:
+			return "anomaly";
+		case RecordType::kSkipped:
+			return "skipped";
+		default:
+			return "unknown";
+		}
+	}
+
+	const char* AnomalyName(std::uint8_t anomaly)
+	{
+		return static_cast<Recorder::AnomalyKind>(anomaly) == Recorder::AnomalyKind::kNoConvergence ? "no convergence" : "unknown";
+	}
+
+	const char* HandsName(std::uint32_t mask)
+	{
+		switch (mask) {
+		case 1:
+			return "left";
+		case 2:
+			return "right";
+		case 3:
+			return "both";
+		default:
+			return "none";
+		}
+	}
+
+	void Describe(const Recorder::Record& record, char* buffer, std::size_t size)
+	{
+		switch (record.type) {
+		case RecordType::kGrip:
+			std::snprintf(buffer, size, "%s%s", record.a ? "pressed" : "released", record.b ? " (refresh)" : "");
+			break;
+		case RecordType::kDeclared:
+			std::snprintf(buffer, size, "%s", record.a ? "active" : "inactive");
+			break;
+		case RecordType::kInjected:
+			std::snprintf(buffer, size, "%s %s hand, held %.1f ms", record.a ? "press" : "release", record.b ? "main" : "off",
+				static_cast<double>(record.value) / 1000.0);
+			break;
+		case RecordType::kCasterState:
+			std::snprintf(buffer, size, "%s -> %s (%s)", RecordedStateName(record.a), RecordedStateName(record.b), HandsName(record.value));
+			break;
+		case RecordType::kDecision:
+			std::snprintf(buffer, size, "%s while %s, retry %u", record.a ? "press" : "release", RecordedStateName(record.b), record.value);
+			break;
+		case RecordType::kAnomaly:
+			std::snprintf(buffer, size, "%s after %u retries", AnomalyName(record.a), record.value);
+			break;
+		case RecordType::kSkipped:
+			std::snprintf(buffer, size, "%s %s, %u pending", record.a ? "press" : "release", record.b == 1 ? "merged" : "dropped", record.value);
+			break;
+		default:
+			std::snprintf(buffer, size, "a=%u b=%u value=%u", record.a, record.b, record.value);
+			break;
+		}
+	}
+
+	bool Print(const char* path, bool csv)
+	{
+		const auto dump = Recorder::LoadDump(path);
+		if (!dump) {
+			std::fprintf(stderr, "%s: not a flight recorder dump (version %u)\n", path, Recorder::DumpHeader::kVersion);
+			return false;
+		}
+
+		const auto& header = dump->header;
+		if (!csv) {
+			std::printf("%s: %s hand, %s, %u records\n", path, header.hand == 0 ? "left" : "right", AnomalyName(header.anomaly), header.recordCount);
+		}
+
+		char description[128];
+		for (const auto& record : dump->records) {
+			const double offsetMs = (static_cast<double>(record.timestampNanoseconds) - static_cast<double>(header.dumpedAtNanoseconds)) / 1e6;
+			Describe(record, description, sizeof(description));
+			if (csv) {
+				std::printf("%s,%s,%.3f,%s,%u,%u,%u,\"%s\"\n", path, record.hand == 0 ? "left" : "right", offsetMs, TypeName(record.type), record.a,
+					record.b, record.value, description);
+			} else {
+				std::printf("  %12.3f ms  %-9s %s\n", offsetMs, TypeName(record.type), description);
+			}
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool csv = false;
+	std::vector<const char*> files;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--csv") == 0) {
+			csv = true;
+		} else {
+			files.push_back(argv[i]);
+		}
+	}
+
+	if (files.empty()) {
+		std::fprintf(stderr, "Usage: %s [--csv] FILE...\n", argv[0]);
+		return 2;
+	}
+
+	if (csv) {
+		std::printf("file,hand,offset_ms,type,a,b,value,description\n");
+	}
+
+	int failures = 0;
+	for (const char* file : files) {
+		failures += Print(file, csv) ? 0 : 1;
+	}
+	return failures > 0 ? 1 : 0;
+}
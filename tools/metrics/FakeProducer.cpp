@@ -0,0 +1,122 @@
+// Publishes made-up metrics the way the plugin does, so ispvr_metrics_reader (or any other reader) can be tried without the game.
+//
+// Usage: ispvr_metrics_fake [--name NAME] [--seconds N] [--seed N]
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <thread>
+
+#include "SharedSegment.h"
+#include "core/Metrics.h"
+
+namespace
+{
+	using namespace std::chrono_literals;
+
+	// Same cadence as the plugin's publisher
+	constexpr auto kPublishInterval = 250ms;
+	constexpr auto kFrame = 11ms;  // 90 Hz headset
+
+	volatile std::sig_atomic_t g_stop = 0;
+
+	void OnSignal(int)
+	{
+		g_stop = 1;
+	}
+
+	/// <summary>
+	/// One frame of plausible activity: the caster hook runs every frame, casts start now and then and cause caster events,
+	/// injected attack events and haptic pulses.
+	/// </summary>
+	void SimulateFrame(std::mt19937_64& rng, bool& casting)
+	{
+		std::lognormal_distribution<double> hookNanoseconds(9.5, 0.6);  // Around 13 us with a long tail
+		Metrics::Record(Metrics::Histogram::kCasterHookNanoseconds, static_cast<std::uint64_t>(hookNanoseconds(rng)));
+
+		std::bernoulli_distribution toggle(casting ? 0.05 : 0.03);  // Casts about once a second
+		if (toggle(rng)) {
+			casting = !casting;
+			// Idle to start to charging, or releasing to idle
+			Metrics::Increment(Metrics::Counter::kCasterEvents, 2);
+			Metrics::Increment(Metrics::Counter::kAttackEventsInjected);
+			if (std::bernoulli_distribution(0.1)(rng)) {
+				Metrics::Increment(Metrics::Counter::kRepresses);
+			}
+		}
+
+		if (casting) {
+			Metrics::Increment(Metrics::Counter::kHapticPulses);
+			if (std::bernoulli_distribution(0.05)(rng)) {
+				Metrics::Increment(Metrics::Counter::kHapticEventsDropped);
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const char* name = Metrics::kPosixSharedMemoryName;
+	double seconds = 0.0;
+	std::uint64_t seed = 1;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+			name = argv[++i];
+		} else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+			seconds = std::strtod(argv[++i], nullptr);
+		} else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		} else {
+			std::fprintf(stderr, "Usage: %s [--name NAME] [--seconds N] [--seed N]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	auto segment = MetricsTools::SharedSegment::Create(name, sizeof(Metrics::SharedSnapshot));
+	if (!segment) {
+		std::fprintf(stderr, "%s\n", MetricsTools::SharedSegment::LastError().c_str());
+		return 1;
+	}
+
+	std::signal(SIGINT, OnSignal);
+	std::signal(SIGTERM, OnSignal);
+
+	auto* snapshot = new (segment->Data()) Metrics::SharedSnapshot{};
+	std::printf("Publishing fake metrics to %s every %lld ms, Ctrl+C to stop\n", name, static_cast<long long>(kPublishInterval.count()));
+
+	std::mt19937_64 rng(seed);
+	bool casting = false;
+	Metrics::SnapshotData data;
+
+	const auto start = std::chrono::steady_clock::now();
+	auto nextFrame = start;
+	auto nextPublish = start;
+	while (!g_stop) {
+		const auto now = std::chrono::steady_clock::now();
+		if (seconds > 0.0 && now - start >= std::chrono::duration<double>(seconds)) {
+			break;
+		}
+
+		if (now >= nextFrame) {
+			SimulateFrame(rng, casting);
+			nextFrame += kFrame;
+		}
+		if (now >= nextPublish) {
+			Metrics::Collect(data);
+			data.publishedAtNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+			Metrics::Publish(*snapshot, data);
+			nextPublish += kPublishInterval;
+		}
+
+		std::this_thread::sleep_until(std::min(nextFrame, nextPublish));
+	}
+
+	std::printf("Stopped, removed %s\n", name);
+	return 0;
+}
@@ -0,0 +1,140 @@
+// Samples the metrics segment without disturbing the producer and prints counters with their rates and histogram percentiles.
+//
+// Usage: ispvr_metrics_reader [--name NAME] [--interval-ms N] [--count N]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <thread>
+
+#include "SharedSegment.h"
+#include "core/Metrics.h"
+
+namespace
+{
+	// Header fields that are checked before the rest of the segment is trusted
+	struct LayoutHeader
+	{
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint32_t size;
+	};
+
+	bool CheckLayout(const MetricsTools::SharedSegment& segment)
+	{
+		const auto* header = static_cast<const LayoutHeader*>(segment.Data());
+		if (header->magic != Metrics::kLayoutMagic) {
+			std::fprintf(stderr, "Not a metrics segment (magic 0x%08x)\n", header->magic);
+			return false;
+		}
+		if (header->version != Metrics::kLayoutVersion || header->size != sizeof(Metrics::SharedSnapshot) ||
+			segment.Size() < sizeof(Metrics::SharedSnapshot)) {
+			std::fprintf(stderr, "Layout version %u (%u bytes) does not match this reader's version %u (%zu bytes)\n", header->version,
+				header->size, Metrics::kLayoutVersion, sizeof(Metrics::SharedSnapshot));
+			return false;
+		}
+		return true;
+	}
+
+	// Upper bound of the bucket that contains the given fraction of the samples
+	std::uint64_t Percentile(const std::array<std::uint64_t, Metrics::kHistogramBuckets>& buckets, std::uint64_t total, double fraction)
+	{
+		const auto rank = static_cast<std::uint64_t>(fraction * static_cast<double>(total));
+		std::uint64_t seen = 0;
+		for (std::size_t i = 0; i < buckets.size(); ++i) {
+			seen += buckets[i];
+			if (seen > rank) {
+				return i == 0 ? 0 : (1ull << i);
+			}
+		}
+		return 1ull << (buckets.size() - 1);
+	}
+
+	void Print(const Metrics::SnapshotData& data, const std::optional<Metrics::SnapshotData>& previous)
+	{
+		// Rates only make sense against an earlier snapshot of the same producer
+		double elapsed = 0.0;
+		if (previous && data.publishedAtNanoseconds > previous->publishedAtNanoseconds) {
+			elapsed = static_cast<double>(data.publishedAtNanoseconds - previous->publishedAtNanoseconds) / 1e9;
+		}
+
+		std::printf("--- published at %.3f s\n", static_cast<double>(data.publishedAtNanoseconds) / 1e9);
+		for (std::size_t i = 0; i < Metrics::kCounterCount; ++i) {
+			const auto value = data.counters[i];
+			if (elapsed > 0.0 && value >= previous->counters[i]) {
+				std::printf("  %-24s %12llu  %10.1f/s\n", Metrics::kCounterNames[i].data(), static_cast<unsigned long long>(value),
+					static_cast<double>(value - previous->counters[i]) / elapsed);
+			} else {
+				std::printf("  %-24s %12llu\n", Metrics::kCounterNames[i].data(), static_cast<unsigned long long>(value));
+			}
+		}
+
+		for (std::size_t h = 0; h < Metrics::kHistogramCount; ++h) {
+			const auto& buckets = data.histograms[h];
+			std::uint64_t total = 0;
+			for (const auto count : buckets) {
+				total += count;
+			}
+			std::printf("  %-24s %12llu samples  p50 < %llu  p99 < %llu\n", Metrics::kHistogramNames[h].data(),
+				static_cast<unsigned long long>(total), static_cast<unsigned long long>(Percentile(buckets, total, 0.50)),
+				static_cast<unsigned long long>(Percentile(buckets, total, 0.99)));
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const char* name = Metrics::kPosixSharedMemoryName;
+	long long intervalMs = 1000;
+	long long count = 0;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+			name = argv[++i];
+		} else if (std::strcmp(argv[i], "--interval-ms") == 0 && i + 1 < argc) {
+			intervalMs = std::max(1ll, std::strtoll(argv[++i], nullptr, 10));
+		} else if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+			count = std::strtoll(argv[++i], nullptr, 10);
+		} else {
+			std::fprintf(stderr, "Usage: %s [--name NAME] [--interval-ms N] [--count N]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	const auto segment = MetricsTools::SharedSegment::Open(name, sizeof(LayoutHeader));
+	if (!segment) {
+		std::fprintf(stderr, "%s\n", MetricsTools::SharedSegment::LastError().c_str());
+		return 1;
+	}
+	if (!CheckLayout(*segment)) {
+		return 1;
+	}
+
+	const auto& snapshot = *static_cast<const Metrics::SharedSnapshot*>(segment->Data());
+	std::optional<Metrics::SnapshotData> previous;
+	for (long long sample = 0; count <= 0 || sample < count; ++sample) {
+		if (sample > 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+		}
+
+		Metrics::SnapshotData data;
+		if (!Metrics::Read(snapshot, data)) {
+			std::printf("--- producer busy, skipped\n");
+			continue;
+		}
+
+		// A restarted producer starts counting from zero again
+		if (previous && data.publishedAtNanoseconds < previous->publishedAtNanoseconds) {
+			previous.reset();
+		}
+
+		Print(data, previous);
+		std::fflush(stdout);
+		previous = data;
+	}
+	return 0;
+}
@@ -0,0 +1,101 @@
+#include "SharedSegment.h"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace MetricsTools
+{
+	namespace
+	{
+		std::string g_lastError;
+
+		void SetError(const char* what, const char* name)
+		{
+			g_lastError = std::string(what) + " '" + name + "': " + std::strerror(errno);
+		}
+	}
+
+	std::optional<SharedSegment> SharedSegment::Create(const char* name, std::size_t size)
+	{
+		const int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+		if (fd < 0) {
+			SetError("Could not create segment", name);
+			return std::nullopt;
+		}
+
+		if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+			SetError("Could not size segment", name);
+			close(fd);
+			shm_unlink(name);
+			return std::nullopt;
+		}
+
+		// The mapping keeps the segment alive, the descriptor is not needed anymore
+		void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED) {
+			SetError("Could not map segment", name);
+			shm_unlink(name);
+			return std::nullopt;
+		}
+		return SharedSegment(name, data, size, true);
+	}
+
+	std::optional<SharedSegment> SharedSegment::Open(const char* name, std::size_t minSize)
+	{
+		const int fd = shm_open(name, O_RDONLY, 0);
+		if (fd < 0) {
+			SetError("Could not open segment", name);
+			return std::nullopt;
+		}
+
+		struct stat info{};
+		if (fstat(fd, &info) != 0) {
+			SetError("Could not inspect segment", name);
+			close(fd);
+			return std::nullopt;
+		}
+		if (static_cast<std::size_t>(info.st_size) < minSize) {
+			g_lastError = std::string("Segment '") + name + "' is too small, is the producer from an older version?";
+			close(fd);
+			return std::nullopt;
+		}
+
+		const auto size = static_cast<std::size_t>(info.st_size);
+		void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED) {
+			SetError("Could not map segment", name);
+			return std::nullopt;
+		}
+		return SharedSegment(name, data, size, false);
+	}
+
+	SharedSegment::SharedSegment(SharedSegment&& other) noexcept :
+		name(std::move(other.name)),
+		data(std::exchange(other.data, nullptr)),
+		size(std::exchange(other.size, 0)),
+		owner(std::exchange(other.owner, false))
+	{}
+
+	SharedSegment::~SharedSegment()
+	{
+		if (data) {
+			munmap(data, size);
+		}
+		if (owner) {
+			shm_unlink(name.c_str());
+		}
+	}
+
+	const std::string& SharedSegment::LastError()
+	{
+		return g_lastError;
+	}
+}
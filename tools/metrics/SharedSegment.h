@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace MetricsTools
+{
+	/// <summary>
+	/// A mapped POSIX shared memory segment. The creating side removes the segment again when it is destroyed.
+	/// </summary>
+	class SharedSegment
+	{
+	public:
+		// Creates (or takes over) a writable segment of the given size
+		static std::optional<SharedSegment> Create(const char* name, std::size_t size);
+
+		// Maps an existing segment read only. Fails if it is smaller than minSize.
+		static std::optional<SharedSegment> Open(const char* name, std::size_t minSize);
+
+		SharedSegment(SharedSegment&& other) noexcept;
+		SharedSegment& operator=(SharedSegment&&) = delete;
+		~SharedSegment();
+
+		[[nodiscard]] void* Data() const { return data; }
+		[[nodiscard]] std::size_t Size() const { return size; }
+
+		// Description of the last failed Create or Open
+		[[nodiscard]] static const std::string& LastError();
+
+	private:
+		SharedSegment(std::string name, void* data, std::size_t size, bool owner) :
+			name(std::move(name)), data(data), size(size), owner(owner) {}
+
+		std::string name;
+		void* data{ nullptr };
+		std::size_t size{ 0 };
+		bool owner{ false };
+	};
+}
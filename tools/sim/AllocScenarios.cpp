@@ -0,0 +1,200 @@
+#include "Scenarios.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "CasterModel.h"
+#include "core/AllocAudit.h"
+#include "core/DispatchStateMachine.h"
+#include "core/FlightRecorder.h"
+#include "core/FrameTasks.h"
+#include "core/HandTracker.h"
+#include "core/HapticFeed.h"
+#include "core/HapticMixer.h"
+#include "core/Metrics.h"
+#include "utils/Clock.h"
+
+namespace Sim
+{
+	namespace
+	{
+		using namespace std::chrono_literals;
+
+		constexpr auto kFrame = std::chrono::nanoseconds(1'000'000'000 / 90);
+		constexpr std::uint64_t kWarmupFrames = 2 * 90;  // One full cast, so every path has run once before counting
+		constexpr std::uint64_t kFrames = 60 * 90;
+
+		// One site per per-frame step of the plugin, named after the code they stand in for
+		AllocAudit::Site g_casterUpdate{ "sim: caster update hook" };
+		AllocAudit::Site g_dispatch{ "sim: dispatcher step" };
+		AllocAudit::Site g_haptics{ "sim: haptics step" };
+		AllocAudit::Site g_frameTasks{ "sim: frame task tick" };
+		AllocAudit::Site g_control{ "sim: control (allocates)" };
+
+		struct Counts
+		{
+			std::uint64_t scopes{ 0 };
+			std::uint64_t allocations{ 0 };
+			std::uint64_t bytes{ 0 };
+		};
+
+		Counts Read(const AllocAudit::Site& site)
+		{
+			return { site.scopes.load(std::memory_order_relaxed), site.allocations.load(std::memory_order_relaxed),
+				site.bytes.load(std::memory_order_relaxed) };
+		}
+
+		// A long lived UI task, like the ones that wait for a caster to go idle. The scheduler destroys it when the pipeline goes.
+		Tasks::Task WatchCaster(const std::atomic<ActualState>& hand)
+		{
+			while (true) {
+				co_await Tasks::WaitUntil([&hand] { return hand.load(std::memory_order_relaxed) == ActualState::kIdle; }, 1s);
+				co_await Tasks::NextFrame();
+			}
+		}
+
+		/// <summary>
+		/// The per-frame work of the plugin for one hand casting over and over: caster update hook, dispatcher, haptics worker and
+		/// frame tasks, each in its own audit scope. Game calls are replaced by the fake caster.
+		/// </summary>
+		struct FramePipeline
+		{
+			Utils::ManualClock clock;
+			CasterModel caster{ {} };
+			std::atomic<ActualState> leftHand{ ActualState::kIdle };
+			std::atomic<ActualState> rightHand{ ActualState::kIdle };
+			CasterStateTracker::HandTracker hands{ leftHand, rightHand };
+			Recorder::FlightRecorder recorder{ 0, clock };
+			InputDispatcher::DispatchStateMachine machine{ clock.Now() };
+			InputDispatcher::InjectionGate gate;
+			Haptics::FeedMailbox mailbox;
+			Haptics::HapticMixer mixer;
+			Tasks::Scheduler scheduler{ clock };
+			int channel{ mixer.AddChannel(0, 1.0f) };
+			std::array<bool, InputDispatcher::InjectionGate::kMaxPending> queued{};  // Attack events waiting for the UI thread
+			std::uint32_t queuedCount{ 0 };
+			std::uint64_t frame{ 0 };
+
+			FramePipeline()
+			{
+				scheduler.Spawn(WatchCaster(leftHand));
+			}
+
+			void Step()
+			{
+				clock.Advance(kFrame);
+				const auto now = clock.Now();
+				++frame;
+
+				// Hold the spell for a second, then rest for one
+				if (frame % 90 == 0) {
+					machine.Declare((frame / 90) % 2 == 1);
+				}
+
+				// Main thread: attack events queued last frame reach the caster, then the caster update hook of both hands
+				{
+					const AllocAudit::Scope scope(g_casterUpdate);
+					for (std::uint32_t i = 0; i < queuedCount; ++i) {
+						gate.OnRun();
+						caster.Input(queued[i], now);
+					}
+					queuedCount = 0;
+					caster.Advance(now);
+
+					for (const bool leftHandCaster : { true, false }) {
+						const auto state = leftHandCaster ? caster.State() : ActualState::kIdle;
+						const auto update = hands.OnCasterUpdate(leftHandCaster, leftHandCaster, state, false);
+						if (update.changedMask) {
+							Metrics::Increment(Metrics::Counter::kCasterEvents);
+							recorder.Record(Recorder::RecordType::kCasterState, static_cast<std::uint8_t>(static_cast<int>(update.previousState) + 1),
+								static_cast<std::uint8_t>(static_cast<int>(update.currentState) + 1), update.changedMask);
+							mailbox.PostState(leftHandCaster, update.previousState, update.currentState);
+						}
+						Metrics::Record(Metrics::Histogram::kCasterHookNanoseconds, 1000);
+					}
+				}
+
+				// Dispatcher worker, stepped every frame instead of on its own schedule
+				{
+					const AllocAudit::Scope scope(g_dispatch);
+					const auto decision = machine.Step(caster.State(), now);
+					if (decision.sendInput) {
+						recorder.Record(Recorder::RecordType::kDecision, decision.pressed ? 1 : 0,
+							static_cast<std::uint8_t>(static_cast<int>(caster.State()) + 1), decision.retries);
+						if (gate.Admit(decision.pressed) == InputDispatcher::InjectionGate::Admission::kQueue) {
+							queued[queuedCount++] = decision.pressed;
+						}
+					}
+				}
+
+				// Haptics worker
+				{
+					const AllocAudit::Scope scope(g_haptics);
+					if (const auto update = mailbox.Take(true); update && update->hasState) {
+						mixer.Schedule(channel, { .pulseInterval = 10, .pulseStrength = 0.5f, .pulses = 3, .interruptPulse = true });
+					}
+					static_cast<void>(mixer.Advance(now));
+				}
+
+				// UI thread
+				{
+					const AllocAudit::Scope scope(g_frameTasks);
+					scheduler.Tick();
+				}
+			}
+		};
+	}
+
+	bool RunFrameAllocations()
+	{
+		if (!AllocAudit::IsEnabled()) {
+			std::printf("  skipped, allocations are only counted in an alloc_audit build (xmake f --alloc_audit=y)\n");
+			return true;
+		}
+
+		bool passed = true;
+
+		// The counting itself works: a scope that does allocate is seen
+		{
+			const auto before = Read(g_control);
+			{
+				const AllocAudit::Scope scope(g_control);
+				std::vector<int> values(16);
+				static_cast<void>(values);
+			}
+			passed &= Check(Read(g_control).allocations > before.allocations, "allocations inside a scope are counted");
+		}
+
+		FramePipeline pipeline;
+		for (std::uint64_t i = 0; i < kWarmupFrames; ++i) {
+			pipeline.Step();
+		}
+
+		const AllocAudit::Site* sites[]{ &g_casterUpdate, &g_dispatch, &g_haptics, &g_frameTasks };
+		Counts before[std::size(sites)];
+		for (std::size_t i = 0; i < std::size(sites); ++i) {
+			before[i] = Read(*sites[i]);
+		}
+
+		for (std::uint64_t i = 0; i < kFrames; ++i) {
+			pipeline.Step();
+		}
+
+		std::printf("  %llu frames at 90 Hz, %llu caster transitions\n", static_cast<unsigned long long>(kFrames),
+			static_cast<unsigned long long>(pipeline.caster.Transitions()));
+		for (std::size_t i = 0; i < std::size(sites); ++i) {
+			const auto after = Read(*sites[i]);
+			const auto allocations = after.allocations - before[i].allocations;
+			const auto bytes = after.bytes - before[i].bytes;
+			std::printf("  %-26s %6llu scopes, %.3f allocations per frame, %llu bytes\n", sites[i]->name,
+				static_cast<unsigned long long>(after.scopes - before[i].scopes), static_cast<double>(allocations) / static_cast<double>(kFrames),
+				static_cast<unsigned long long>(bytes));
+			passed &= Check(allocations == 0, "%s does not allocate", sites[i]->name);
+		}
+		return passed;
+	}
+}
@@ -0,0 +1,75 @@
+#include "CasterModel.h"
+
+namespace Sim
+{
+	bool CasterModel::Input(bool pressed, Utils::Clock::time_point now)
+	{
+		if (now < ignoreUntil) {
+			++ignoredInputs;
+			return false;
+		}
+
+		if (pressed) {
+			if (state == ActualState::kIdle) {
+				Enter(ActualState::kStart, now);
+				return true;
+			}
+			return false;
+		}
+
+		switch (state) {
+		case ActualState::kStart:
+		case ActualState::kCharging:
+			// Let go before the spell was charged, the cast is cancelled
+			Enter(ActualState::kIdle, now);
+			return true;
+		case ActualState::kHolding:
+			Enter(ActualState::kReleasing, now);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	std::optional<Utils::Clock::time_point> CasterModel::NextTransition() const
+	{
+		switch (state) {
+		case ActualState::kStart:
+			return stateSince + timings.start;
+		case ActualState::kCharging:
+			return stateSince + timings.charge;
+		case ActualState::kReleasing:
+			return stateSince + timings.release;
+		default:
+			return std::nullopt;
+		}
+	}
+
+	bool CasterModel::Advance(Utils::Clock::time_point now)
+	{
+		const auto due = NextTransition();
+		if (!due || now < *due) {
+			return false;
+		}
+
+		switch (state) {
+		case ActualState::kStart:
+			Enter(ActualState::kCharging, *due);
+			break;
+		case ActualState::kCharging:
+			Enter(ActualState::kHolding, *due);
+			break;
+		default:
+			Enter(ActualState::kIdle, *due);
+			break;
+		}
+		return true;
+	}
+
+	void CasterModel::Enter(ActualState next, Utils::Clock::time_point now)
+	{
+		state = next;
+		stateSince = now;
+		++transitions;
+	}
+}
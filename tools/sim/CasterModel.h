@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "core/CasterState.h"
+#include "utils/Clock.h"
+
+namespace Sim
+{
+	using CasterStateTracker::ActualState;
+
+	/// <summary>
+	/// Stand-in for a hand's MagicCaster with a charged fire and forget spell equipped. Attack button events start or release
+	/// the cast, the remaining transitions run on timers. Like the game it can ignore input for a while (stagger, scripted scenes).
+	/// </summary>
+	class CasterModel
+	{
+	public:
+		struct Timings
+		{
+			Utils::Clock::duration start{ std::chrono::milliseconds(50) };  // kStart to kCharging
+			Utils::Clock::duration charge{ std::chrono::milliseconds(500) };  // kCharging to kHolding
+			Utils::Clock::duration release{ std::chrono::milliseconds(300) };  // kReleasing to kIdle
+		};
+
+		explicit CasterModel(Timings timings) :
+			timings(timings) {}
+
+		[[nodiscard]] ActualState State() const { return state; }
+
+		/// <summary>
+		/// Applies an attack button event. Returns true if the state changed.
+		/// </summary>
+		bool Input(bool pressed, Utils::Clock::time_point now);
+
+		// Drops all input until the given time
+		void IgnoreInputUntil(Utils::Clock::time_point until) { ignoreUntil = until; }
+
+		// When the next timed transition is due, nothing if the state only changes on input
+		[[nodiscard]] std::optional<Utils::Clock::time_point> NextTransition() const;
+
+		/// <summary>
+		/// Runs the timed transition if it is due. Returns true if the state changed.
+		/// </summary>
+		bool Advance(Utils::Clock::time_point now);
+
+		[[nodiscard]] std::uint64_t Transitions() const { return transitions; }
+		[[nodiscard]] std::uint64_t IgnoredInputs() const { return ignoredInputs; }
+
+	private:
+		void Enter(ActualState next, Utils::Clock::time_point now);
+
+		Timings timings;
+		ActualState state{ ActualState::kIdle };
+		Utils::Clock::time_point stateSince{};
+		Utils::Clock::time_point ignoreUntil{};
+
+		std::uint64_t transitions{ 0 };
+		std::uint64_t ignoredInputs{ 0 };
+	};
+}
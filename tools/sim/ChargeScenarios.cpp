@@ -0,0 +1,128 @@
+#include "Scenarios.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include "CasterModel.h"
+#include "core/HandTracker.h"
+
+namespace Sim
+{
+	namespace
+	{
+		using namespace std::chrono_literals;
+		using CasterStateTracker::ActualState;
+
+		constexpr auto kFrame = std::chrono::nanoseconds(1'000'000'000 / 90);
+		constexpr std::uint32_t kChargeSteps = 64;  // What the spell haptics subscribe with
+
+		// The input dispatcher and the spell haptics follow caster state, the spell haptics also follow the charge
+		constexpr std::uint64_t kStateListeners = 2;
+
+		struct CastCounts
+		{
+			std::uint64_t casts{ 0 };
+			std::uint64_t transitions{ 0 };
+			std::uint64_t listenerCalls{ 0 };
+			std::uint64_t dispatcherWakeups{ 0 };
+			std::uint64_t chargeCalls{ 0 };
+		};
+
+		/// <summary>
+		/// Runs casts frame by frame and counts callbacks the way the caster update hook sends them now, and the way it did when
+		/// every charging frame was a state event for all listeners.
+		/// </summary>
+		void RunCasts(Utils::Clock::duration charge, std::uint64_t casts, CastCounts& before, CastCounts& after)
+		{
+			std::atomic<ActualState> left{ ActualState::kIdle };
+			std::atomic<ActualState> right{ ActualState::kIdle };
+			CasterStateTracker::HandTracker tracker(left, right);
+			CasterModel caster({ .charge = charge });
+
+			auto now = Utils::Clock::time_point{};
+			for (std::uint64_t cast = 0; cast < casts; ++cast) {
+				caster.Input(true, now);
+				const auto releaseAt = now + 50ms + charge + 300ms;
+				bool released = false;
+				Utils::Clock::time_point chargeStart{};
+				std::int64_t lastStep = -1;
+
+				while (!released || caster.State() != ActualState::kIdle) {
+					now += kFrame;
+					if (!released && now >= releaseAt) {
+						caster.Input(false, now);
+						released = true;
+					}
+					while (caster.Advance(now)) {}
+
+					const auto state = caster.State();
+					const auto update = tracker.OnCasterUpdate(false, false, state, false);
+					const bool charging = state == ActualState::kCharging;
+
+					if (update.changedMask != 0) {
+						++after.transitions;
+						++before.transitions;
+						after.listenerCalls += kStateListeners;
+						++after.dispatcherWakeups;
+						chargeStart = charging ? now : chargeStart;
+					}
+					if (update.changedMask != 0 || charging) {
+						before.listenerCalls += kStateListeners;
+						++before.dispatcherWakeups;
+					}
+
+					if (update.chargeMask == 0) {
+						continue;
+					}
+					if (!charging) {
+						lastStep = -1;
+						continue;
+					}
+					const float progress = std::chrono::duration<float>(now - chargeStart) / std::chrono::duration<float>(charge);
+					const auto step = CasterStateTracker::ChargeStepFor(progress > 1.0f ? 1.0f : progress, kChargeSteps);
+					if (step != lastStep) {
+						lastStep = step;
+						++after.chargeCalls;
+						++after.listenerCalls;
+					}
+				}
+
+				now += 500ms;
+			}
+			before.casts += casts;
+			after.casts += casts;
+		}
+
+		double PerCast(std::uint64_t value, const CastCounts& counts)
+		{
+			return counts.casts ? static_cast<double>(value) / static_cast<double>(counts.casts) : 0.0;
+		}
+	}
+
+	bool RunChargeEvents()
+	{
+		constexpr std::uint64_t kCasts = 100;
+
+		bool passed = true;
+		for (const auto charge : { 500ms, 1000ms, 2000ms, 4000ms }) {
+			CastCounts before;
+			CastCounts after;
+			RunCasts(charge, kCasts, before, after);
+
+			std::printf("  %4lld ms charge at 90 Hz, per cast: listener calls %.1f before, %.1f now (%.1f charge steps), dispatcher wakeups %.1f before, %.1f now\n",
+				static_cast<long long>(charge.count()), PerCast(before.listenerCalls, before),
+				PerCast(after.listenerCalls, after), PerCast(after.chargeCalls, after), PerCast(before.dispatcherWakeups, before),
+				PerCast(after.dispatcherWakeups, after));
+
+			// Charging no longer wakes the dispatcher, it only wakes for actual transitions
+			passed &= Check(after.dispatcherWakeups == after.transitions && after.dispatcherWakeups < before.dispatcherWakeups,
+				"%lld ms: dispatcher wakes once per transition (%llu for %llu)", static_cast<long long>(charge.count()),
+				static_cast<unsigned long long>(after.dispatcherWakeups), static_cast<unsigned long long>(after.transitions));
+			passed &= Check(after.chargeCalls <= (kChargeSteps + 1) * after.casts, "%lld ms: at most %u charge steps per cast",
+				static_cast<long long>(charge.count()), kChargeSteps + 1);
+		}
+		return passed;
+	}
+}
@@ -0,0 +1,234 @@
+#include "Scenarios.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <span>
+
+#include "CasterModel.h"
+#include "core/HandTracker.h"
+
+namespace Sim
+{
+	namespace
+	{
+		using namespace std::chrono_literals;
+		using CasterStateTracker::ActualState;
+		using CasterStateTracker::HandTracker;
+
+		// States both hand casters report on one frame, in the order the game updates them
+		struct Frame
+		{
+			ActualState offHandCaster;  // Left-hand casting source
+			ActualState mainHandCaster;  // Right-hand casting source
+		};
+
+		// An off hand cast. While dual casting the game keeps the main hand caster idle, only the off hand caster drives both hands.
+		constexpr Frame kOffHandCast[]{
+			{ ActualState::kIdle, ActualState::kIdle },
+			{ ActualState::kStart, ActualState::kIdle },
+			{ ActualState::kCharging, ActualState::kIdle },
+			{ ActualState::kCharging, ActualState::kIdle },
+			{ ActualState::kHolding, ActualState::kIdle },
+			{ ActualState::kReleasing, ActualState::kIdle },
+			{ ActualState::kIdle, ActualState::kIdle },
+		};
+		constexpr std::uint32_t kOffHandTransitions = 5;
+		constexpr std::uint32_t kChargingUpdates = 3;  // Two charging frames and the one leaving kCharging
+
+		struct Outcome
+		{
+			std::uint32_t events{ 0 };
+			std::uint32_t unexpectedMasks{ 0 };
+			std::uint32_t unexpectedPrevious{ 0 };
+			std::uint32_t chargeUpdatesLeft{ 0 };
+			std::uint32_t chargeUpdatesRight{ 0 };
+			ActualState finalLeft{ ActualState::kUnknown };
+			ActualState finalRight{ ActualState::kUnknown };
+		};
+
+		Outcome Drive(bool leftHanded, bool dualCasting, std::span<const Frame> frames)
+		{
+			std::atomic<ActualState> left{ ActualState::kIdle };
+			std::atomic<ActualState> right{ ActualState::kIdle };
+			HandTracker tracker(left, right);
+
+			const bool offHandLeft = HandOrientation::IsPhysicalLeft(false, leftHanded);
+			const std::uint8_t expectedMask = dualCasting ? CasterStateTracker::kBothHandsMask : CasterStateTracker::HandMaskFor(offHandLeft);
+
+			Outcome outcome;
+			ActualState lastOffHand = ActualState::kIdle;
+			for (const auto& frame : frames) {
+				for (const bool leftHandCaster : { true, false }) {
+					const auto state = leftHandCaster ? frame.offHandCaster : frame.mainHandCaster;
+					const bool physicalLeft = HandOrientation::IsPhysicalLeft(!leftHandCaster, leftHanded);
+					const auto update = tracker.OnCasterUpdate(leftHandCaster, physicalLeft, state, dualCasting);
+
+					outcome.chargeUpdatesLeft += (update.chargeMask & CasterStateTracker::kLeftHandMask) ? 1 : 0;
+					outcome.chargeUpdatesRight += (update.chargeMask & CasterStateTracker::kRightHandMask) ? 1 : 0;
+					if (update.changedMask == 0) {
+						continue;
+					}
+
+					++outcome.events;
+					outcome.unexpectedMasks += update.changedMask != expectedMask ? 1 : 0;
+					outcome.unexpectedPrevious += update.previousState != lastOffHand ? 1 : 0;
+					lastOffHand = state;
+				}
+			}
+
+			outcome.finalLeft = left.load();
+			outcome.finalRight = right.load();
+			return outcome;
+		}
+
+		bool CheckMapping(bool leftHanded)
+		{
+			bool passed = true;
+			for (const bool physicalLeft : { true, false }) {
+				const bool isMain = HandOrientation::IsMainHand(physicalLeft, leftHanded);
+				// The main hand is the physical right one, unless left-handed mode is on
+				const bool expectedMain = leftHanded ? physicalLeft : !physicalLeft;
+				passed &= Check(isMain == expectedMain && HandOrientation::IsPhysicalLeft(isMain, leftHanded) == physicalLeft,
+					"left-handed %d: physical %s hand is the %s hand", leftHanded, physicalLeft ? "left" : "right", isMain ? "main" : "off");
+			}
+			return passed;
+		}
+
+		bool CheckCast(bool leftHanded, bool dualCasting)
+		{
+			const auto outcome = Drive(leftHanded, dualCasting, kOffHandCast);
+			const bool offHandLeft = HandOrientation::IsPhysicalLeft(false, leftHanded);
+
+			// Without dual casting only the off hand follows the cast, with it both hands do
+			const std::uint32_t expectedLeft = (dualCasting || offHandLeft) ? kChargingUpdates : 0;
+			const std::uint32_t expectedRight = (dualCasting || !offHandLeft) ? kChargingUpdates : 0;
+
+			bool passed = true;
+			passed &= Check(outcome.events == kOffHandTransitions && outcome.unexpectedMasks == 0 && outcome.unexpectedPrevious == 0,
+				"left-handed %d, dual %d: %u events for %u transitions, %u with the wrong hands, %u with the wrong previous state",
+				leftHanded, dualCasting, outcome.events, kOffHandTransitions, outcome.unexpectedMasks, outcome.unexpectedPrevious);
+			passed &= Check(outcome.chargeUpdatesLeft == expectedLeft && outcome.chargeUpdatesRight == expectedRight,
+				"left-handed %d, dual %d: charge updates left %u (expected %u), right %u (expected %u)", leftHanded, dualCasting,
+				outcome.chargeUpdatesLeft, expectedLeft, outcome.chargeUpdatesRight, expectedRight);
+			passed &= Check(outcome.finalLeft == ActualState::kIdle && outcome.finalRight == ActualState::kIdle,
+				"left-handed %d, dual %d: both hands idle after the cast", leftHanded, dualCasting);
+			return passed;
+		}
+
+		// While dual casting, a main hand caster that reports something else must not move either hand
+		bool CheckIgnoredMainHand(bool leftHanded)
+		{
+			constexpr Frame kDiverging[]{
+				{ ActualState::kCharging, ActualState::kIdle },
+				{ ActualState::kCharging, ActualState::kReleasing },
+				{ ActualState::kHolding, ActualState::kStart },
+			};
+			const auto outcome = Drive(leftHanded, true, kDiverging);
+			return Check(outcome.events == 2 && outcome.finalLeft == ActualState::kHolding && outcome.finalRight == ActualState::kHolding,
+				"left-handed %d, dual 1: main hand caster ignored, %u events, hands end in holding", leftHanded, outcome.events);
+		}
+
+		struct CallbackCounts
+		{
+			std::uint64_t events{ 0 };
+			std::uint64_t listenerCalls{ 0 };
+			std::uint64_t wakeupsLeft{ 0 };  // Dispatcher and haptics worker of each hand
+			std::uint64_t wakeupsRight{ 0 };
+			std::uint64_t singleHandEvents{ 0 };
+		};
+
+		// Listeners that run for every caster event: input dispatcher and spell haptics
+		constexpr std::uint64_t kStateListeners = 2;
+
+		void Count(const HandTracker::Update& update, CallbackCounts& counts)
+		{
+			if (update.changedMask == 0) {
+				return;
+			}
+			++counts.events;
+			counts.listenerCalls += kStateListeners;
+			counts.wakeupsLeft += (update.changedMask & CasterStateTracker::kLeftHandMask) ? 1 : 0;
+			counts.wakeupsRight += (update.changedMask & CasterStateTracker::kRightHandMask) ? 1 : 0;
+			counts.singleHandEvents += update.changedMask != CasterStateTracker::kBothHandsMask ? 1 : 0;
+		}
+	}
+
+	bool RunDualCastEvents()
+	{
+		constexpr std::uint64_t kCasts = 1000;
+		constexpr auto kFrame = std::chrono::nanoseconds(1'000'000'000 / 90);
+
+		// Both hands cast the same spell, the game updates the left-hand and then the right-hand caster every frame
+		std::atomic<ActualState> left{ ActualState::kIdle };
+		std::atomic<ActualState> right{ ActualState::kIdle };
+		HandTracker tracker(left, right);
+
+		// The same casts as two separate events per change, like before dual casting was coalesced
+		std::atomic<ActualState> separateLeft{ ActualState::kIdle };
+		std::atomic<ActualState> separateRight{ ActualState::kIdle };
+		HandTracker separate(separateLeft, separateRight);
+
+		CasterModel caster({});
+		std::mt19937_64 rng(1);
+		std::uniform_int_distribution<int> holdMs(0, 2000);
+
+		CallbackCounts now;
+		CallbackCounts before;
+		auto time = Utils::Clock::time_point{};
+		for (std::uint64_t cast = 0; cast < kCasts; ++cast) {
+			caster.Input(true, time);
+			const auto releaseAt = time + 550ms + std::chrono::milliseconds(holdMs(rng));
+			bool released = false;
+
+			while (!released || caster.State() != ActualState::kIdle) {
+				time += kFrame;
+				if (!released && time >= releaseAt) {
+					caster.Input(false, time);
+					released = true;
+				}
+				while (caster.Advance(time)) {}
+
+				for (const bool leftHandCaster : { true, false }) {
+					const bool physicalLeft = HandOrientation::IsPhysicalLeft(!leftHandCaster, false);
+					Count(tracker.OnCasterUpdate(leftHandCaster, physicalLeft, caster.State(), true), now);
+					Count(separate.OnCasterUpdate(leftHandCaster, physicalLeft, caster.State(), false), before);
+				}
+			}
+			time += 300ms;
+		}
+
+		const auto transitions = caster.Transitions();
+		const auto perTransition = [transitions](std::uint64_t value) {
+			return transitions ? static_cast<double>(value) / static_cast<double>(transitions) : 0.0;
+		};
+		std::printf("  %llu dual casts, %llu transitions. Per transition: events %.2f before, %.2f now; listener calls %.2f before, %.2f now\n",
+			static_cast<unsigned long long>(kCasts), static_cast<unsigned long long>(transitions), perTransition(before.events),
+			perTransition(now.events), perTransition(before.listenerCalls), perTransition(now.listenerCalls));
+
+		bool passed = true;
+		passed &= Check(now.events == transitions && now.singleHandEvents == 0, "one event for both hands per transition (%llu events, %llu for a single hand)",
+			static_cast<unsigned long long>(now.events), static_cast<unsigned long long>(now.singleHandEvents));
+		passed &= Check(now.wakeupsLeft == transitions && now.wakeupsRight == transitions, "each hand woken once per transition (left %llu, right %llu)",
+			static_cast<unsigned long long>(now.wakeupsLeft), static_cast<unsigned long long>(now.wakeupsRight));
+		passed &= Check(now.listenerCalls * 2 == before.listenerCalls, "listener calls halved (%llu before, %llu now)",
+			static_cast<unsigned long long>(before.listenerCalls), static_cast<unsigned long long>(now.listenerCalls));
+		passed &= Check(left.load() == ActualState::kIdle && right.load() == ActualState::kIdle, "both hands idle at the end");
+		return passed;
+	}
+
+	bool RunHandMatrix()
+	{
+		bool passed = true;
+		for (const bool leftHanded : { false, true }) {
+			passed &= CheckMapping(leftHanded);
+			for (const bool dualCasting : { false, true }) {
+				passed &= CheckCast(leftHanded, dualCasting);
+			}
+			passed &= CheckIgnoredMainHand(leftHanded);
+		}
+		return passed;
+	}
+}
@@ -0,0 +1,156 @@
+#include "Scenarios.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "utils/Clock.h"
+#include "utils/FrameClock.h"
+#include "utils/TimedWorker.h"
+
+namespace Sim
+{
+	namespace
+	{
+		using namespace std::chrono_literals;
+		using TimePoint = Utils::Clock::time_point;
+
+		// Timed waits need real time, so unlike the other scenarios this one runs on the steady clock and takes a few seconds
+		constexpr auto kRunTime = 600ms;
+		constexpr auto kWorkerInterval = 20ms;  // Dispatcher retry interval
+
+		class ProbeWorker : public Utils::TimedWorker
+		{
+		public:
+			ProbeWorker()
+			{
+				runs.reserve(1024);
+				minInterval.store(kWorkerInterval, std::memory_order::relaxed);
+			}
+
+			~ProbeWorker() override
+			{
+				Stop();
+			}
+
+			// Only written by the worker thread, read after Stop()
+			std::vector<TimePoint> runs;
+
+		private:
+			void Work() override
+			{
+				if (runs.size() < runs.capacity()) {
+					runs.push_back(clock.Now());
+				}
+			}
+		};
+
+		struct Jitter
+		{
+			double offsetP50Ms{ 0.0 };  // Time from the start of the frame to the run
+			double offsetP90Ms{ 0.0 };
+			double intervalStdDevMs{ 0.0 };  // Spread of the time between runs
+			std::size_t runs{ 0 };
+		};
+
+		double Percentile(std::vector<double> values, double p)
+		{
+			if (values.empty()) {
+				return 0.0;
+			}
+			std::ranges::sort(values);
+			return values[static_cast<std::size_t>(p * static_cast<double>(values.size() - 1) + 0.5)];
+		}
+
+		Jitter Measure(int hz, bool frameAligned)
+		{
+			const auto period = std::chrono::duration_cast<Utils::Clock::duration>(std::chrono::nanoseconds(1'000'000'000 / hz));
+			Utils::FrameClock frames;
+			ProbeWorker worker;
+			std::vector<TimePoint> frameStarts;
+			frameStarts.reserve(static_cast<std::size_t>(kRunTime / period) + 16);
+
+			auto& clock = Utils::Clock::Steady();
+			auto next = clock.Now();
+			const auto end = next + kRunTime;
+
+			// A few frames first so the frame period is known before the worker starts
+			for (int i = 0; i < 4; ++i, next += period) {
+				std::this_thread::sleep_until(next);
+				frames.Tick(clock.Now());
+			}
+			if (frameAligned) {
+				worker.SetFrameClock(&frames);
+			}
+			worker.Start();
+
+			// Frame loop, like the per-frame hook on the main thread
+			while (next < end) {
+				std::this_thread::sleep_until(next);
+				const auto now = clock.Now();
+				frameStarts.push_back(now);
+				frames.Tick(now);
+				next += period;
+			}
+			worker.SetFrameClock(nullptr);
+			worker.Stop();
+
+			// Runs before the first measured frame come from starting the worker, not from its schedule
+			Jitter jitter;
+			std::vector<double> offsets;
+			std::vector<double> intervals;
+			const TimePoint* previous = nullptr;
+			for (const auto& run : worker.runs) {
+				const auto frame = std::upper_bound(frameStarts.begin(), frameStarts.end(), run);
+				if (frame == frameStarts.begin()) {
+					continue;
+				}
+				offsets.push_back(std::chrono::duration<double, std::milli>(run - *std::prev(frame)).count());
+				if (previous) {
+					intervals.push_back(std::chrono::duration<double, std::milli>(run - *previous).count());
+				}
+				previous = &run;
+			}
+
+			double mean = 0.0;
+			for (const double interval : intervals) {
+				mean += interval;
+			}
+			mean = intervals.empty() ? 0.0 : mean / static_cast<double>(intervals.size());
+			double variance = 0.0;
+			for (const double interval : intervals) {
+				variance += (interval - mean) * (interval - mean);
+			}
+
+			jitter.offsetP50Ms = Percentile(offsets, 0.5);
+			jitter.offsetP90Ms = Percentile(offsets, 0.9);
+			jitter.intervalStdDevMs = intervals.empty() ? 0.0 : std::sqrt(variance / static_cast<double>(intervals.size()));
+			jitter.runs = offsets.size();
+			return jitter;
+		}
+	}
+
+	bool RunFrameJitter()
+	{
+		bool passed = true;
+		for (const int hz : { 72, 90, 120, 144 }) {
+			const double periodMs = 1000.0 / hz;
+			const auto free = Measure(hz, false);
+			const auto aligned = Measure(hz, true);
+
+			std::printf("  %3d Hz  free running: %3zu runs, frame offset p50 %5.2f p90 %5.2f ms, interval sd %5.2f ms\n", hz, free.runs,
+				free.offsetP50Ms, free.offsetP90Ms, free.intervalStdDevMs);
+			std::printf("  %3d Hz  frame aligned: %3zu runs, frame offset p50 %5.2f p90 %5.2f ms, interval sd %5.2f ms\n", hz, aligned.runs,
+				aligned.offsetP50Ms, aligned.offsetP90Ms, aligned.intervalStdDevMs);
+
+			// Aligned runs follow the frame start by no more than the wakeup latency, free running ones land anywhere in the frame
+			passed &= Check(aligned.runs > 0 && aligned.offsetP90Ms < periodMs / 4 && aligned.offsetP90Ms < free.offsetP90Ms,
+				"%d Hz: frame aligned runs land at the start of the frame (p90 %.2f ms of %.2f)", hz, aligned.offsetP90Ms, periodMs);
+		}
+		return passed;
+	}
+}
@@ -0,0 +1,79 @@
+#include "Scenarios.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+
+#include "core/FlightRecorder.h"
+#include "utils/Clock.h"
+
+namespace Sim
+{
+	namespace
+	{
+		using namespace std::chrono_literals;
+		using Recorder::RecordType;
+
+		bool SameRecords(const std::vector<Recorder::Record>& a, const std::vector<Recorder::Record>& b)
+		{
+			if (a.size() != b.size()) {
+				return false;
+			}
+			for (std::size_t i = 0; i < a.size(); ++i) {
+				if (a[i].timestampNanoseconds != b[i].timestampNanoseconds || a[i].type != b[i].type || a[i].hand != b[i].hand
+					|| a[i].a != b[i].a || a[i].b != b[i].b || a[i].value != b[i].value) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	bool RunFlightDump()
+	{
+		Utils::ManualClock clock;
+		clock.Advance(1s);
+		Recorder::FlightRecorder recorder(1, clock);
+
+		// Twice the capacity of a stuck hand: grip, declaration and re-presses that the caster ignores
+		constexpr std::uint32_t kRecords = 2 * Recorder::FlightRecorder::kCapacity;
+		recorder.Record(RecordType::kGrip, 1);
+		recorder.Record(RecordType::kDeclared, 1);
+		for (std::uint32_t i = 2; i < kRecords - 1; ++i) {
+			clock.Advance(10ms);
+			recorder.Record((i & 1) ? RecordType::kInjected : RecordType::kDecision, 1, 1, i);
+		}
+		recorder.Record(RecordType::kAnomaly, static_cast<std::uint8_t>(Recorder::AnomalyKind::kNoConvergence), 0, 20);
+
+		std::error_code error;
+		const auto path = std::filesystem::temp_directory_path(error) / "ispvr_sim_flight.bin";
+		bool passed = Check(!error && recorder.Dump(path, Recorder::AnomalyKind::kNoConvergence), "dump written to %s", path.string().c_str());
+
+		const auto snapshot = recorder.Snapshot();
+		const auto dump = Recorder::LoadDump(path);
+		std::filesystem::remove(path, error);
+
+		passed &= Check(dump.has_value(), "dump loads back");
+		if (!dump) {
+			return false;
+		}
+
+		const bool oldestFirst = !snapshot.empty() && snapshot.front().value == kRecords - Recorder::FlightRecorder::kCapacity
+			&& snapshot.back().type == RecordType::kAnomaly;
+		passed &= Check(snapshot.size() == Recorder::FlightRecorder::kCapacity && oldestFirst, "ring keeps the last %zu of %u records, oldest first",
+			snapshot.size(), kRecords);
+		passed &= Check(SameRecords(snapshot, dump->records), "dump has the same %u records", dump->header.recordCount);
+		passed &= Check(dump->header.hand == 1 && dump->header.anomaly == static_cast<std::uint8_t>(Recorder::AnomalyKind::kNoConvergence),
+			"header keeps hand and anomaly");
+
+		// A truncated file is rejected instead of decoded into garbage
+		{
+			recorder.Dump(path, Recorder::AnomalyKind::kNoConvergence);
+			std::filesystem::resize_file(path, sizeof(Recorder::DumpHeader) + 8, error);
+			passed &= Check(!error && !Recorder::LoadDump(path), "truncated dump is rejected");
+			std::filesystem::remove(path, error);
+		}
+		return passed;
+	}
+}
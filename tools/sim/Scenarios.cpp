@@ -0,0 +1,39 @@
+#include "Scenarios.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace Sim
+{
+	namespace
+	{
+		constexpr Scenario kScenarios[]{
+			{ "hands", "hand orientation and caster tracking, left-handed mode x dual casting", RunHandMatrix },
+			{ "dual-cast-events", "callbacks per transition while dual casting, one event for both hands vs one per caster", RunDualCastEvents },
+			{ "charge-events", "listener calls and dispatcher wakeups per cast, per-frame charging events vs charge steps", RunChargeEvents },
+			{ "frame-tasks", "frame task scheduler stepped frame by frame: next frame, delays, caster state waits, timeouts", RunFrameTasks },
+			{ "flight-dump", "flight recorder ring, dump and load round trip", RunFlightDump },
+			{ "frame-jitter", "worker wakeups against 72/90/120/144 Hz frames, free running vs frame aligned (real time)", RunFrameJitter },
+			{ "frame-allocations", "heap allocations per simulated frame in the caster hook, dispatcher, haptics and frame tasks (alloc_audit build)", RunFrameAllocations },
+			{ "spell-table", "spell metadata table built from a synthetic form list: order, duplicates, lookups, haptic profiles", RunSpellTable },
+			{ "charge-rebalance", "charge time bonuses planned for a synthetic spell set: which spells, how much, no compounding", RunChargeRebalance },
+			{ "stuck-dispatch", "caster ignoring input and UI stalls: watchdog give-up, retry backoff, merged and dropped injections", RunStuckDispatch },
+		};
+	}
+
+	std::span<const Scenario> Scenarios()
+	{
+		return kScenarios;
+	}
+
+	bool Check(bool passed, const char* format, ...)
+	{
+		std::printf("  %s ", passed ? "ok  " : "FAIL");
+		va_list args;
+		va_start(args, format);
+		std::vprintf(format, args);
+		va_end(args);
+		std::printf("\n");
+		return passed;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <span>
+
+namespace Sim
+{
+	/// <summary>
+	/// Self-checking simulation of one behaviour, run with --scenario. Prints what it measured and returns false if a check failed.
+	/// </summary>
+	struct Scenario
+	{
+		const char* name;
+		const char* description;
+		bool (*run)();
+	};
+
+	[[nodiscard]] std::span<const Scenario> Scenarios();
+
+	// Prints the outcome of a single check, returns whether it passed
+	bool Check(bool passed, const char* format, ...);
+
+	// HandScenarios.cpp
+	bool RunHandMatrix();
+	bool RunDualCastEvents();
+
+	// ChargeScenarios.cpp
+	bool RunChargeEvents();
+
+	// TaskScenarios.cpp
+	bool RunFrameTasks();
+
+	// RecorderScenarios.cpp
+	bool RunFlightDump();
+
+	// JitterScenarios.cpp
+	bool RunFrameJitter();
+
+	// AllocScenarios.cpp
+	bool RunFrameAllocations();
+
+	// SpellScenarios.cpp
+	bool RunSpellTable();
+	bool RunChargeRebalance();
+
+	// StuckScenarios.cpp
+	bool RunStuckDispatch();
+}
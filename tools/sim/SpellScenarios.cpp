@@ -0,0 +1,188 @@
+#include "Scenarios.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/ChargeRebalance.h"
+#include "core/SpellTable.h"
+
+namespace Sim
+{
+	namespace
+	{
+		using Spells::CastingType;
+		using Spells::Delivery;
+		using Spells::HapticProfile;
+		using Spells::SpellType;
+
+		constexpr std::size_t kSpellCount = 40000;  // A large load order, spells of all plugins together
+		constexpr std::size_t kLookups = 100000;
+
+		bool SameInfo(const Spells::SpellInfo& a, const Spells::SpellInfo& b)
+		{
+			return a.formID == b.formID && a.chargeTime == b.chargeTime && a.spellType == b.spellType && a.castingType == b.castingType
+				&& a.delivery == b.delivery && a.learnable == b.learnable && a.invertInput == b.invertInput && a.hapticProfile == b.hapticProfile;
+		}
+
+		/// <summary>
+		/// Made-up form list with the shapes a load order has: form IDs spread over many plugin indices in no particular order,
+		/// every spell type, casting type and delivery, and some form IDs that appear twice (overrides read twice).
+		/// </summary>
+		std::vector<Spells::SpellSource> MakeFormList(std::size_t count, std::uint64_t seed)
+		{
+			constexpr std::string_view kNames[]{ "Flames", "Healing", "Telekinesis", "Fireball", "Candlelight", "Wall of Frost" };
+
+			std::mt19937_64 rng(seed);
+			auto pick = [&rng](std::uint32_t count) { return std::uniform_int_distribution<std::uint32_t>(0, count - 1)(rng); };
+
+			std::vector<Spells::SpellSource> sources;
+			sources.reserve(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				if (i > 0 && pick(50) == 0) {
+					auto duplicate = sources[pick(static_cast<std::uint32_t>(sources.size()))];
+					duplicate.chargeTime += 1.0f;  // Differs from the first occurrence, which has to win
+					sources.push_back(duplicate);
+					continue;
+				}
+				sources.push_back({
+					.formID = (pick(0xFE) << 24) | pick(0x1000000),
+					.spellType = static_cast<SpellType>(pick(static_cast<std::uint32_t>(SpellType::kScroll) + 1)),
+					.castingType = static_cast<CastingType>(pick(static_cast<std::uint32_t>(CastingType::kScroll) + 1)),
+					.delivery = static_cast<Delivery>(pick(static_cast<std::uint32_t>(Delivery::kTargetLocation) + 1)),
+					.chargeTime = static_cast<float>(pick(5)) * 0.05f * static_cast<float>(pick(20)),
+					.learnable = pick(2) == 0,
+					.name = kNames[pick(static_cast<std::uint32_t>(std::size(kNames)))],
+				});
+			}
+			return sources;
+		}
+
+		// The spells that play the shortened hand cast animations
+		bool UsesHandCastAnimations(const Spells::SpellInfo& spell)
+		{
+			return spell.spellType == SpellType::kSpell && spell.castingType == CastingType::kFireAndForget && spell.learnable;
+		}
+
+		bool CheckDescribe()
+		{
+			bool passed = true;
+
+			const auto flames = Spells::Describe({ .formID = 1, .castingType = CastingType::kConcentration, .chargeTime = 0.0f, .name = "Flames" });
+			passed &= Check(flames.invertInput && flames.hapticProfile == HapticProfile::kConcentration,
+				"concentration spells are cast with an open hand and get the concentration profile");
+
+			const auto telekinesis = Spells::Describe({ .formID = 2, .castingType = CastingType::kConcentration, .chargeTime = 0.0f, .name = "Telekinesis" });
+			passed &= Check(!telekinesis.invertInput && telekinesis.hapticProfile == HapticProfile::kInstant,
+				"Telekinesis is aimed like a fire and forget spell");
+
+			const auto instant = Spells::Describe({ .formID = 3, .castingType = CastingType::kFireAndForget, .chargeTime = 0.05f, .name = "Candlelight" });
+			const auto charged = Spells::Describe({ .formID = 4, .castingType = CastingType::kFireAndForget, .chargeTime = 0.1f, .name = "Fireball" });
+			passed &= Check(instant.hapticProfile == HapticProfile::kInstant && charged.hapticProfile == HapticProfile::kCharged,
+				"fire and forget spells below 0.1 s charge are instant, from 0.1 s on charged");
+			return passed;
+		}
+	}
+
+	bool RunSpellTable()
+	{
+		bool passed = CheckDescribe();
+
+		const auto sources = MakeFormList(kSpellCount, 1);
+
+		const auto buildStart = std::chrono::steady_clock::now();
+		const auto table = Spells::SpellTable::Build(sources);
+		const auto buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+
+		// First occurrence of every form ID, which is what the table has to keep
+		std::unordered_map<std::uint32_t, std::size_t> first;
+		for (std::size_t i = 0; i < sources.size(); ++i) {
+			first.try_emplace(sources[i].formID, i);
+		}
+		std::printf("  %zu sources, %zu distinct form IDs, built in %.2f ms\n", sources.size(), first.size(), buildMs);
+
+		const auto entries = table.Entries();
+		passed &= Check(table.Size() == first.size(), "one entry per form ID (%zu)", table.Size());
+		passed &= Check(std::ranges::adjacent_find(entries, std::ranges::greater_equal{}, &Spells::SpellInfo::formID) == entries.end(),
+			"entries are sorted by form ID without duplicates");
+
+		std::size_t mismatched = 0;
+		for (const auto& [formID, index] : first) {
+			const auto* info = table.Find(formID);
+			mismatched += (info && SameInfo(*info, Spells::Describe(sources[index]))) ? 0 : 1;
+		}
+		passed &= Check(mismatched == 0, "every form ID is found and described from its first occurrence (%zu mismatched)", mismatched);
+
+		// Form IDs of other forms, a lookup for them has to miss
+		std::mt19937_64 rng(2);
+		std::vector<std::uint32_t> others;
+		others.reserve(kLookups);
+		while (others.size() < kLookups) {
+			if (const auto formID = static_cast<std::uint32_t>(rng()); !first.contains(formID)) {
+				others.push_back(formID);
+			}
+		}
+		std::size_t found = 0;
+		const auto findStart = std::chrono::steady_clock::now();
+		for (const auto formID : others) {
+			found += table.Find(formID) ? 1 : 0;
+		}
+		const auto findNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - findStart).count() / static_cast<double>(others.size());
+		passed &= Check(found == 0, "form IDs that are not spells are not found (%.0f ns per lookup)", findNs);
+
+		const auto empty = Spells::SpellTable::Build({});
+		passed &= Check(empty.Size() == 0 && !empty.Find(0) && !empty.Find(0xFFFFFFFF), "an empty form list gives an empty table");
+		return passed;
+	}
+
+	bool RunChargeRebalance()
+	{
+		bool passed = true;
+		const auto table = Spells::SpellTable::Build(MakeFormList(kSpellCount, 3));
+		const Spells::RemovedAnimationTimes times{ .aimedCharge = 0.4f, .selfCharge = 0.25f, .release = 0.15f };
+
+		const auto plan = Spells::PlanChargeTimes(table.Entries(), times);
+		const auto affected = std::ranges::count_if(table.Entries(), UsesHandCastAnimations);
+		std::printf("  %zu spells, %zu hand cast fire and forget spells the player can learn, %zu planned\n", table.Size(),
+			static_cast<std::size_t>(affected), plan.size());
+		passed &= Check(plan.size() == static_cast<std::size_t>(affected) && affected > 0, "exactly the hand cast spells get a bonus");
+
+		std::size_t wrong = 0;
+		for (const auto& bonus : plan) {
+			const auto* spell = table.Find(bonus.formID);
+			const float expected = spell ? (spell->delivery == Delivery::kSelf ? times.selfCharge : times.aimedCharge) + times.release : 0.0f;
+			wrong += (spell && UsesHandCastAnimations(*spell) && bonus.seconds == expected) ? 0 : 1;
+		}
+		passed &= Check(wrong == 0, "self spells gain the self charge, all others the aimed charge, both plus the release (%zu wrong)", wrong);
+
+		// One of each type that must be left alone, otherwise identical to a spell that gets the bonus
+		std::size_t rebalanced = 0;
+		for (const auto type : { SpellType::kDisease, SpellType::kPower, SpellType::kLesserPower, SpellType::kAbility, SpellType::kVoicePower,
+				 SpellType::kScroll, SpellType::kStaffEnchantment }) {
+			const auto info = Spells::Describe({ .formID = 1, .spellType = type, .chargeTime = 0.5f, .learnable = true, .name = "Fireball" });
+			rebalanced += Spells::ChargeTimeBonusFor(info, times) > 0.0f ? 1 : 0;
+		}
+		const auto concentration = Spells::Describe({ .formID = 1, .castingType = CastingType::kConcentration, .learnable = true, .name = "Flames" });
+		const auto npcOnly = Spells::Describe({ .formID = 1, .chargeTime = 0.5f, .learnable = false, .name = "Fireball" });
+		rebalanced += Spells::ChargeTimeBonusFor(concentration, times) > 0.0f ? 1 : 0;
+		rebalanced += Spells::ChargeTimeBonusFor(npcOnly, times) > 0.0f ? 1 : 0;
+		passed &= Check(rebalanced == 0, "powers, shouts, diseases, concentration and NPC only spells are left alone (%zu rebalanced)", rebalanced);
+
+		// The table keeps the loaded charge times, so planning again gives the same bonus instead of adding to the last one
+		const auto again = Spells::PlanChargeTimes(table.Entries(), times);
+		const bool same = std::ranges::equal(plan, again, [](const Spells::ChargeTimeBonus& a, const Spells::ChargeTimeBonus& b) {
+			return a.formID == b.formID && a.seconds == b.seconds;
+		});
+		passed &= Check(same, "planning twice gives the same bonuses");
+
+		const auto none = Spells::PlanChargeTimes(table.Entries(), {});
+		const auto negative = Spells::PlanChargeTimes(table.Entries(), { .aimedCharge = -1.0f, .selfCharge = -1.0f, .release = -1.0f });
+		passed &= Check(none.empty() && negative.empty(), "zero and negative removed times plan nothing");
+		return passed;
+	}
+}
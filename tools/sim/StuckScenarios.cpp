@@ -0,0 +1,236 @@
+#include "Scenarios.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include "CasterModel.h"
+#include "core/DispatchStateMachine.h"
+#include "core/Metrics.h"
+#include "utils/Clock.h"
+
+namespace Sim
+{
+	namespace
+	{
+		using namespace std::chrono_literals;
+		using InputDispatcher::DispatchStateMachine;
+		using InputDispatcher::InjectionGate;
+		using TimePoint = Utils::Clock::time_point;
+		using Duration = Utils::Clock::duration;
+
+		constexpr auto kStep = 1ms;
+		constexpr auto kLatency = 12ms;  // Attack event queued until the caster reacts, about one frame
+
+		std::uint64_t CounterValue(Metrics::Counter counter)
+		{
+			Metrics::SnapshotData data;
+			Metrics::Collect(data);
+			return data.counters[static_cast<std::size_t>(counter)];
+		}
+
+		/// <summary>
+		/// One hand in virtual time, stepped in 1 ms ticks: the dispatcher state machine runs whenever the real worker would wake
+		/// up, admitted attack events reach the fake caster after a frame or once a UI stall is over.
+		/// </summary>
+		struct StuckRig
+		{
+			struct Injection
+			{
+				TimePoint arrival;
+				bool pressed;
+			};
+
+			Utils::ManualClock clock;
+			CasterModel caster{ {} };
+			DispatchStateMachine machine{ clock.Now() };
+			InjectionGate gate;
+			std::deque<Injection> queue;
+			TimePoint stallUntil{};
+			std::optional<TimePoint> wake;
+			bool notified{ false };
+
+			std::vector<TimePoint> sends;  // Every attack event the state machine asked for
+			std::uint64_t giveUps{ 0 };
+			TimePoint gaveUpAt{};
+			std::uint64_t queued{ 0 };
+			std::uint64_t merged{ 0 };
+			std::uint64_t dropped{ 0 };
+			std::uint32_t maxPending{ 0 };
+
+			void Declare(bool active)
+			{
+				notified |= machine.Declare(active);
+			}
+
+			void RunFor(Duration duration)
+			{
+				const auto end = clock.Now() + duration;
+				while (clock.Now() < end) {
+					clock.Advance(kStep);
+					const auto now = clock.Now();
+
+					bool changed = false;
+					while (!queue.empty() && queue.front().arrival <= now) {
+						gate.OnRun();
+						changed |= caster.Input(queue.front().pressed, now);
+						queue.pop_front();
+					}
+					changed |= caster.Advance(now);
+
+					// The caster state listener notifies the dispatcher, otherwise it sleeps until its retry interval is over
+					if (!changed && !notified && !(wake && now >= *wake)) {
+						continue;
+					}
+					notified = false;
+
+					const auto decision = machine.Step(caster.State(), now);
+					wake = decision.nextInterval.count() > 0 ? std::optional(now + decision.nextInterval) : std::nullopt;
+					if (decision.gaveUp) {
+						++giveUps;
+						gaveUpAt = now;
+					}
+					if (!decision.sendInput) {
+						continue;
+					}
+
+					sends.push_back(now);
+					switch (gate.Admit(decision.pressed)) {
+					case InjectionGate::Admission::kQueue:
+						queue.push_back({ std::max(now + kLatency, stallUntil), decision.pressed });
+						++queued;
+						break;
+					case InjectionGate::Admission::kMerge:
+						++merged;
+						break;
+					case InjectionGate::Admission::kDrop:
+						++dropped;
+						break;
+					}
+					maxPending = std::max(maxPending, gate.Pending());
+				}
+			}
+
+			// Time from the start of the run to the caster reaching the declared state, nothing if it never did
+			std::optional<Duration> RunUntilActive(bool active, Duration timeout)
+			{
+				const auto start = clock.Now();
+				while (clock.Now() - start < timeout) {
+					if (CasterStateTracker::IsStateActive(caster.State()) == active) {
+						return clock.Now() - start;
+					}
+					RunFor(kStep);
+				}
+				return std::nullopt;
+			}
+		};
+
+		double Ms(Duration duration)
+		{
+			return std::chrono::duration<double, std::milli>(duration).count();
+		}
+
+		bool CheckLongStagger()
+		{
+			bool passed = true;
+			const auto tripsBefore = CounterValue(Metrics::Counter::kWatchdogTrips);
+
+			// The caster ignores input for longer than the watchdog retries
+			StuckRig rig;
+			const auto start = rig.clock.Now();
+			rig.caster.IgnoreInputUntil(start + 10s);
+			rig.Declare(true);
+			rig.RunFor(10s);
+
+			const auto retries = rig.sends.empty() ? 0 : rig.sends.size() - 1;
+			std::printf("  10 s stagger: %zu events, gave up after %.0f ms\n", rig.sends.size(), rig.giveUps ? Ms(rig.gaveUpAt - start) : -1.0);
+			passed &= Check(rig.giveUps == 1 && retries == DispatchStateMachine::kMaxRetries, "watchdog gives up once after %u re-presses (%zu)",
+				DispatchStateMachine::kMaxRetries, retries);
+			passed &= Check(CounterValue(Metrics::Counter::kWatchdogTrips) - tripsBefore == 1, "the give-up is counted in kWatchdogTrips");
+
+			// Re-press n follows press n - 1 after RetryIntervalFor(n - 1), the interval the previous step asked for
+			std::size_t offSchedule = 0;
+			for (std::size_t i = 2; i < rig.sends.size(); ++i) {
+				const auto expected = DispatchStateMachine::RetryIntervalFor(static_cast<std::uint32_t>(i - 1));
+				offSchedule += (rig.sends[i] - rig.sends[i - 1] == expected) ? 0 : 1;
+			}
+			passed &= Check(offSchedule == 0 && rig.sends.size() > 2 && rig.sends[1] - rig.sends[0] == DispatchStateMachine::kRetryInterval,
+				"re-presses every %lld ms, then doubling up to %lld ms (%zu off schedule)",
+				static_cast<long long>(DispatchStateMachine::kRetryInterval.count()), static_cast<long long>(DispatchStateMachine::kMaxRetryInterval.count()),
+				offSchedule);
+
+			// Given up, the hand stays quiet even though the stagger is over, until the grip changes
+			const auto sent = rig.sends.size();
+			rig.RunFor(5s);
+			passed &= Check(rig.sends.size() == sent, "no events after giving up while the caster state does not change");
+
+			rig.Declare(false);
+			rig.RunFor(100ms);
+			rig.Declare(true);
+			const auto latency = rig.RunUntilActive(true, 1s);
+			passed &= Check(latency.has_value() && rig.giveUps == 1, "a new grip re-arms the watchdog and casts (%.0f ms)", latency ? Ms(*latency) : -1.0);
+			return passed;
+		}
+
+		bool CheckShortStagger()
+		{
+			// The caster ignores input for a second, the backed off retries still catch the end of it
+			StuckRig rig;
+			const auto staggerEnd = rig.clock.Now() + 1s;
+			rig.caster.IgnoreInputUntil(staggerEnd);
+			rig.Declare(true);
+			const auto latency = rig.RunUntilActive(true, 5s);
+
+			const auto afterStagger = latency ? Ms(rig.clock.Now() - staggerEnd) : -1.0;
+			std::printf("  1 s stagger: %zu events, caster followed %.0f ms after the stagger\n", rig.sends.size(), afterStagger);
+			return Check(latency && rig.giveUps == 0 && afterStagger <= Ms(DispatchStateMachine::RetryIntervalFor(static_cast<std::uint32_t>(rig.sends.size())) + kLatency),
+				"casts within one retry interval after a 1 s stagger, without giving up");
+		}
+
+		bool CheckUiStall()
+		{
+			bool passed = true;
+
+			// The UI thread runs no tasks for 2 s while the caster would follow right away
+			StuckRig rig;
+			rig.stallUntil = rig.clock.Now() + 2s;
+			rig.Declare(true);
+			const auto latency = rig.RunUntilActive(true, 5s);
+
+			std::printf("  2 s UI stall: %zu events, %llu queued, %llu merged, %llu dropped\n", rig.sends.size(), static_cast<unsigned long long>(rig.queued),
+				static_cast<unsigned long long>(rig.merged), static_cast<unsigned long long>(rig.dropped));
+			passed &= Check(rig.queued == 1 && rig.merged + 1 == rig.sends.size(), "re-presses while the press is still queued are merged into it");
+			passed &= Check(latency && Ms(*latency) <= Ms(2s + kStep), "casts as soon as the stall is over (%.0f ms)", latency ? Ms(*latency) : -1.0);
+
+			// Grip flapping during a stall alternates press and release, nothing beyond kMaxPending is queued
+			StuckRig flapping;
+			flapping.stallUntil = flapping.clock.Now() + 2s;
+			for (int i = 0; i < 20; ++i) {
+				flapping.Declare(i % 2 == 0);
+				flapping.RunFor(50ms);
+			}
+			flapping.Declare(true);
+			const auto settled = flapping.RunUntilActive(true, 5s);
+
+			std::printf("  2 s UI stall, grip flapping: %zu events, %llu queued, %llu merged, %llu dropped\n", flapping.sends.size(),
+				static_cast<unsigned long long>(flapping.queued), static_cast<unsigned long long>(flapping.merged),
+				static_cast<unsigned long long>(flapping.dropped));
+			passed &= Check(flapping.maxPending == InjectionGate::kMaxPending && flapping.dropped > 0, "at most %u events wait for the UI thread",
+				InjectionGate::kMaxPending);
+			passed &= Check(settled.has_value(), "the caster ends up in the last declared state");
+			return passed;
+		}
+	}
+
+	bool RunStuckDispatch()
+	{
+		bool passed = CheckLongStagger();
+		passed &= CheckShortStagger();
+		passed &= CheckUiStall();
+		return passed;
+	}
+}
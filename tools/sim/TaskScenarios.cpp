@@ -0,0 +1,172 @@
+#include "Scenarios.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "core/CasterState.h"
+#include "core/FrameTasks.h"
+#include "utils/Clock.h"
+
+namespace Sim
+{
+	namespace
+	{
+		using namespace std::chrono_literals;
+		using CasterStateTracker::ActualState;
+
+		constexpr auto kFrame = std::chrono::nanoseconds(1'000'000'000 / 90);
+
+		// Steps a scheduler like the UI thread does, one tick per frame on a manual clock
+		struct FrameDriver
+		{
+			Utils::ManualClock clock;
+			Tasks::Scheduler scheduler{ clock };
+			std::uint64_t frame{ 0 };
+
+			void Step()
+			{
+				clock.Advance(kFrame);
+				++frame;
+				scheduler.Tick();
+			}
+
+			// Steps until no task is pending, returns false if that takes longer than maxFrames
+			bool RunUntilIdle(std::uint64_t maxFrames)
+			{
+				for (std::uint64_t i = 0; i < maxFrames && scheduler.HasPending(); ++i) {
+					Step();
+				}
+				return !scheduler.HasPending();
+			}
+		};
+
+		Tasks::Task CountFrames(std::uint64_t frames, const FrameDriver& driver, std::uint64_t& resumedOn)
+		{
+			for (std::uint64_t i = 0; i < frames; ++i) {
+				co_await Tasks::NextFrame();
+			}
+			resumedOn = driver.frame;
+		}
+
+		Tasks::Task WaitFor(Utils::Clock::duration delay, const FrameDriver& driver, Utils::Clock::time_point& resumedAt)
+		{
+			co_await Tasks::Delay(delay);
+			resumedAt = driver.clock.Now();
+		}
+
+		Tasks::Task WaitForState(const std::atomic<ActualState>& hand, Utils::Clock::duration timeout, const FrameDriver& driver,
+			std::uint64_t& resumedOn, bool& reached)
+		{
+			reached = co_await Tasks::WaitUntil([&hand] { return hand.load(std::memory_order_relaxed) == ActualState::kIdle; }, timeout);
+			resumedOn = driver.frame;
+		}
+
+		Tasks::Task SpawnChild(FrameDriver& driver, std::uint64_t& childRanOn)
+		{
+			// A task spawned while the scheduler ticks runs its first step on the next tick
+			driver.scheduler.Spawn([](const FrameDriver& driver, std::uint64_t& childRanOn) -> Tasks::Task {
+				childRanOn = driver.frame;
+				co_return;
+			}(driver, childRanOn));
+			co_return;
+		}
+
+		bool CheckNextFrame()
+		{
+			FrameDriver driver;
+			std::uint64_t resumedOn = 0;
+			driver.scheduler.Spawn(CountFrames(3, driver, resumedOn));
+			const bool finished = driver.RunUntilIdle(10);
+			// The first tick runs the task up to its first await, three more resume it
+			return Check(finished && resumedOn == 4, "3 x NextFrame() finishes on frame %llu (expected 4)", static_cast<unsigned long long>(resumedOn));
+		}
+
+		bool CheckDelay()
+		{
+			FrameDriver driver;
+			Utils::Clock::time_point resumedAt{};
+			driver.scheduler.Spawn(WaitFor(50ms, driver, resumedAt));
+			const bool finished = driver.RunUntilIdle(100);
+
+			// Resumed on the first frame at or after the deadline, which started one frame in
+			const auto waited = resumedAt - Utils::Clock::time_point(kFrame);
+			return Check(finished && waited >= 50ms && waited < 50ms + kFrame, "Delay(50ms) at 90 Hz resumes after %.1f ms",
+				std::chrono::duration<double, std::milli>(waited).count());
+		}
+
+		bool CheckCasterState()
+		{
+			bool passed = true;
+
+			// The hand goes idle on frame 10, the task resumes on that frame's tick
+			{
+				FrameDriver driver;
+				std::atomic<ActualState> hand{ ActualState::kReleasing };
+				std::uint64_t resumedOn = 0;
+				bool reached = false;
+				driver.scheduler.Spawn(WaitForState(hand, 1s, driver, resumedOn, reached));
+				while (driver.frame < 9) {
+					driver.Step();
+				}
+				hand.store(ActualState::kIdle);
+				driver.RunUntilIdle(100);
+				passed &= Check(reached && resumedOn == 10, "caster state wait resumes on the frame the hand went idle (%llu)",
+					static_cast<unsigned long long>(resumedOn));
+			}
+
+			// The hand never goes idle, the wait gives up after its timeout
+			{
+				FrameDriver driver;
+				std::atomic<ActualState> hand{ ActualState::kHolding };
+				std::uint64_t resumedOn = 0;
+				bool reached = true;
+				driver.scheduler.Spawn(WaitForState(hand, 250ms, driver, resumedOn, reached));
+				const bool finished = driver.RunUntilIdle(100);
+				const auto expectedFrame = 1 + (250ms + kFrame - std::chrono::nanoseconds(1)) / kFrame;
+				passed &= Check(finished && !reached && resumedOn == static_cast<std::uint64_t>(expectedFrame),
+					"caster state wait times out after 250 ms on frame %llu (expected %lld)", static_cast<unsigned long long>(resumedOn),
+					static_cast<long long>(expectedFrame));
+			}
+			return passed;
+		}
+
+		bool CheckSpawnFromTask()
+		{
+			FrameDriver driver;
+			std::uint64_t childRanOn = 0;
+			driver.scheduler.Spawn(SpawnChild(driver, childRanOn));
+			const bool finished = driver.RunUntilIdle(10);
+			return Check(finished && childRanOn == 2, "task spawned from a task runs on the next frame (%llu)", static_cast<unsigned long long>(childRanOn));
+		}
+
+		bool CheckManyTasks()
+		{
+			constexpr std::uint64_t kTasks = 1000;
+			FrameDriver driver;
+			std::uint64_t resumedOn[kTasks]{};
+			for (std::uint64_t i = 0; i < kTasks; ++i) {
+				driver.scheduler.Spawn(CountFrames(1 + i % 8, driver, resumedOn[i]));
+			}
+			const bool finished = driver.RunUntilIdle(20);
+
+			std::uint64_t wrong = 0;
+			for (std::uint64_t i = 0; i < kTasks; ++i) {
+				wrong += resumedOn[i] != 2 + i % 8 ? 1 : 0;
+			}
+			return Check(finished && wrong == 0, "%llu tasks of 1 - 8 frames, %llu finished on the wrong frame", static_cast<unsigned long long>(kTasks),
+				static_cast<unsigned long long>(wrong));
+		}
+	}
+
+	bool RunFrameTasks()
+	{
+		bool passed = true;
+		passed &= CheckNextFrame();
+		passed &= CheckDelay();
+		passed &= CheckCasterState();
+		passed &= CheckSpawnFromTask();
+		passed &= CheckManyTasks();
+		return passed;
+	}
+}
@@ -0,0 +1,336 @@
+// Headless casting simulator. Drives the dispatcher state machine against a fake caster in virtual time, so thousands of
+// casts run in well under a second and every run with the same seed gives the same numbers. --scenario runs one of the
+// self-checking scenarios instead (or all of them) and exits with an error if a check fails.
+//
+// Usage: ispvr_sim [--casts N] [--seed N] [--latency-ms N] [--stagger P] [--stall P] [--long-hold P]
+//        ispvr_sim --scenario NAME|all
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "CasterModel.h"
+#include "Scenarios.h"
+#include "core/DispatchStateMachine.h"
+#include "core/Metrics.h"
+#include "utils/Clock.h"
+#include "utils/TimedWorker.h"
+
+namespace
+{
+	using namespace std::chrono_literals;
+	using TimePoint = Utils::Clock::time_point;
+	using Duration = Utils::Clock::duration;
+
+	struct Options
+	{
+		std::uint64_t casts = 10000;
+		std::uint64_t seed = 1;
+		Duration latency = 12ms;  // Attack event queued until the caster reacts, about one frame
+		double staggerChance = 0.05;  // Per cast, the caster ignores input for 0.1 - 8 s
+		double stallChance = 0.02;  // Per cast, the UI thread runs no tasks for 0.1 - 2 s
+		double longHoldChance = 0.1;  // Per cast, the spell is held for 2 - 15 s
+		const char* scenario = nullptr;
+	};
+
+	/// <summary>
+	/// HandInputDispatcher without the game: steps the state machine with the fake caster's state and hands the decisions to
+	/// the simulation. Never started, the simulation runs it with RunOnce() whenever the real one would wake up.
+	/// </summary>
+	class SimDispatcher : public Utils::TimedWorker
+	{
+	public:
+		SimDispatcher(Utils::ManualClock& clock, const Sim::CasterModel& caster, std::function<void(bool)> send) :
+			TimedWorker(clock),
+			machine(clock.Now()),
+			caster(caster),
+			send(std::move(send))
+		{
+			minInterval.store(0ms, std::memory_order_relaxed);
+		}
+
+		InputDispatcher::DispatchStateMachine machine;
+		std::uint64_t giveUps{ 0 };
+
+	private:
+		void Work() override
+		{
+			const auto decision = machine.Step(caster.State(), clock.Now());
+			minInterval.store(decision.nextInterval, std::memory_order_relaxed);
+			if (decision.sendInput) {
+				send(decision.pressed);
+			}
+			if (decision.gaveUp) {
+				++giveUps;
+			}
+		}
+
+		const Sim::CasterModel& caster;
+		std::function<void(bool)> send;
+	};
+
+	struct Results
+	{
+		std::vector<double> pressLatencyMs;
+		std::vector<double> releaseLatencyMs;
+		std::uint64_t unconverged{ 0 };  // Declarations the caster never followed before the next one
+		std::uint64_t sent{ 0 };
+		std::uint64_t merged{ 0 };
+		std::uint64_t dropped{ 0 };
+		std::uint64_t giveUps{ 0 };
+		std::uint64_t ignoredInputs{ 0 };
+		std::uint64_t transitions{ 0 };
+		Duration simulated{ 0 };
+	};
+
+	Results Run(const Options& options)
+	{
+		std::mt19937_64 rng(options.seed);
+		auto uniform = [&rng](Duration min, Duration max) {
+			return Duration(std::uniform_int_distribution<Duration::rep>(min.count(), max.count())(rng));
+		};
+		auto chance = [&rng](double p) { return std::bernoulli_distribution(p)(rng); };
+
+		Results results;
+		Utils::ManualClock clock;
+		Sim::CasterModel caster({});
+		InputDispatcher::InjectionGate gate;
+
+		// Attack events waiting for the UI thread, in the order they reach the caster
+		struct Injection
+		{
+			TimePoint arrival;
+			bool pressed;
+		};
+		std::deque<Injection> queue;
+		TimePoint stallUntil{};
+
+		SimDispatcher dispatcher(clock, caster, [&](bool pressed) {
+			switch (gate.Admit(pressed)) {
+			case InputDispatcher::InjectionGate::Admission::kQueue:
+				queue.push_back({ std::max(clock.Now() + options.latency, stallUntil), pressed });
+				++results.sent;
+				break;
+			case InputDispatcher::InjectionGate::Admission::kMerge:
+				++results.merged;
+				break;
+			case InputDispatcher::InjectionGate::Admission::kDrop:
+				++results.dropped;
+				break;
+			}
+		});
+
+		struct Declaration
+		{
+			bool active;
+			TimePoint at;
+		};
+		std::optional<Declaration> pending;
+
+		std::optional<TimePoint> wake;
+		TimePoint nextDeclaration{};
+		bool declareActive = true;
+		std::uint64_t declaredCasts = 0;
+		TimePoint tailEnd = TimePoint::max();
+
+		while (true) {
+			auto now = nextDeclaration;
+			if (const auto transition = caster.NextTransition()) {
+				now = std::min(now, *transition);
+			}
+			if (!queue.empty()) {
+				now = std::min(now, queue.front().arrival);
+			}
+			if (wake) {
+				now = std::min(now, *wake);
+			}
+			if (now == TimePoint::max() || now > tailEnd) {
+				break;
+			}
+			clock.Set(now);
+
+			bool runDispatcher = false;
+			while (!queue.empty() && queue.front().arrival <= now) {
+				gate.OnRun();
+				runDispatcher |= caster.Input(queue.front().pressed, now);
+				queue.pop_front();
+			}
+			runDispatcher |= caster.Advance(now);
+
+			if (now >= nextDeclaration) {
+				if (pending) {
+					++results.unconverged;
+				}
+				pending = Declaration{ declareActive, now };
+				dispatcher.machine.Declare(declareActive);
+				runDispatcher = true;
+
+				if (declareActive) {
+					if (chance(options.staggerChance)) {
+						caster.IgnoreInputUntil(now + uniform(100ms, 8s));
+					}
+					if (chance(options.stallChance)) {
+						stallUntil = now + uniform(100ms, 2s);
+					}
+					// Some spells are held charged for a long time, long enough for the watchdog to give up during a stagger
+					nextDeclaration = now + (chance(options.longHoldChance) ? uniform(2s, 15s) : uniform(50ms, 2s));
+				} else if (++declaredCasts < options.casts) {
+					nextDeclaration = now + uniform(100ms, 1s);
+				} else {
+					// Give the last release time to finish
+					nextDeclaration = TimePoint::max();
+					tailEnd = now + 10s;
+				}
+				declareActive = !declareActive;
+			}
+
+			if (pending && CasterStateTracker::IsStateActive(caster.State()) == pending->active) {
+				const auto latency = std::chrono::duration<double, std::milli>(now - pending->at).count();
+				(pending->active ? results.pressLatencyMs : results.releaseLatencyMs).push_back(latency);
+				pending.reset();
+			}
+
+			if (runDispatcher || (wake && now >= *wake)) {
+				wake = dispatcher.RunOnce();
+			}
+		}
+
+		results.unconverged += pending ? 1 : 0;
+		results.giveUps = dispatcher.giveUps;
+		results.ignoredInputs = caster.IgnoredInputs();
+		results.transitions = caster.Transitions();
+		results.simulated = clock.Now().time_since_epoch();
+		return results;
+	}
+
+	double Percentile(const std::vector<double>& sorted, double p)
+	{
+		if (sorted.empty()) {
+			return 0.0;
+		}
+		const auto index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+
+	void PrintLatency(const char* name, std::vector<double> samples)
+	{
+		std::ranges::sort(samples);
+		double sum = 0.0;
+		for (const double sample : samples) {
+			sum += sample;
+		}
+		const double mean = samples.empty() ? 0.0 : sum / static_cast<double>(samples.size());
+		std::printf("  %-16s n=%-7zu mean %7.1f  p50 %7.1f  p95 %7.1f  p99 %7.1f  max %8.1f ms\n", name, samples.size(), mean,
+			Percentile(samples, 0.50), Percentile(samples, 0.95), Percentile(samples, 0.99), samples.empty() ? 0.0 : samples.back());
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i) {
+			const char* arg = argv[i];
+			const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+			if (!value) {
+				return false;
+			}
+			++i;
+
+			if (std::strcmp(arg, "--casts") == 0) {
+				options.casts = std::strtoull(value, nullptr, 10);
+			} else if (std::strcmp(arg, "--seed") == 0) {
+				options.seed = std::strtoull(value, nullptr, 10);
+			} else if (std::strcmp(arg, "--latency-ms") == 0) {
+				options.latency = std::chrono::milliseconds(std::strtoll(value, nullptr, 10));
+			} else if (std::strcmp(arg, "--stagger") == 0) {
+				options.staggerChance = std::clamp(std::strtod(value, nullptr), 0.0, 1.0);
+			} else if (std::strcmp(arg, "--stall") == 0) {
+				options.stallChance = std::clamp(std::strtod(value, nullptr), 0.0, 1.0);
+			} else if (std::strcmp(arg, "--long-hold") == 0) {
+				options.longHoldChance = std::clamp(std::strtod(value, nullptr), 0.0, 1.0);
+			} else if (std::strcmp(arg, "--scenario") == 0) {
+				options.scenario = value;
+			} else {
+				return false;
+			}
+		}
+		return options.casts > 0;
+	}
+
+	int RunScenarios(const char* name)
+	{
+		const bool all = std::strcmp(name, "all") == 0;
+		int ran = 0;
+		int failed = 0;
+		for (const auto& scenario : Sim::Scenarios()) {
+			if (!all && std::strcmp(name, scenario.name) != 0) {
+				continue;
+			}
+
+			std::printf("scenario %s: %s\n", scenario.name, scenario.description);
+			const bool passed = scenario.run();
+			std::printf("  %s\n", passed ? "passed" : "FAILED");
+			++ran;
+			failed += passed ? 0 : 1;
+		}
+
+		if (ran == 0) {
+			std::fprintf(stderr, "Unknown scenario %s, available:\n", name);
+			for (const auto& scenario : Sim::Scenarios()) {
+				std::fprintf(stderr, "  %-20s %s\n", scenario.name, scenario.description);
+			}
+			return 2;
+		}
+
+		if (failed > 0) {
+			std::printf("%d of %d scenario(s) failed\n", failed, ran);
+			return 1;
+		}
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::fprintf(stderr, "Usage: %s [--casts N] [--seed N] [--latency-ms N] [--stagger P] [--stall P] [--long-hold P]\n", argv[0]);
+		std::fprintf(stderr, "       %s --scenario NAME|all\n", argv[0]);
+		return 2;
+	}
+
+	if (options.scenario) {
+		return RunScenarios(options.scenario);
+	}
+
+	const auto wallStart = std::chrono::steady_clock::now();
+	const auto results = Run(options);
+	const auto wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+	const auto simulated = std::chrono::duration<double>(results.simulated).count();
+
+	Metrics::SnapshotData metrics;
+	Metrics::Collect(metrics);
+	const auto counter = [&metrics](Metrics::Counter c) {
+		return static_cast<unsigned long long>(metrics.counters[static_cast<std::size_t>(c)]);
+	};
+
+	std::printf("ispvr_sim: %llu casts, seed %llu, %.1f s simulated in %.3f s (%.0fx real time)\n",
+		static_cast<unsigned long long>(options.casts), static_cast<unsigned long long>(options.seed), simulated, wall,
+		wall > 0.0 ? simulated / wall : 0.0);
+	PrintLatency("press latency", results.pressLatencyMs);
+	PrintLatency("release latency", results.releaseLatencyMs);
+	std::printf("  events           sent %llu, merged %llu, dropped %llu, represses %llu, ignored by caster %llu\n",
+		static_cast<unsigned long long>(results.sent), static_cast<unsigned long long>(results.merged),
+		static_cast<unsigned long long>(results.dropped), counter(Metrics::Counter::kRepresses),
+		static_cast<unsigned long long>(results.ignoredInputs));
+	std::printf("  caster           %llu transitions, %llu declarations never reached, watchdog gave up %llu times\n",
+		static_cast<unsigned long long>(results.transitions), static_cast<unsigned long long>(results.unconverged),
+		static_cast<unsigned long long>(results.giveUps));
+	return 0;
+}
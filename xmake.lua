@@ -7,7 +7,10 @@ set_config("skyrim_ae", false)
 set_config("skyrim_vr", true)
 set_config("rex_ini", true)
 
-includes("lib/commonlibsse-ng")
+-- CommonLibSSE-NG (and with it the plugin target) is only available on Windows
+if is_plat("windows") then
+    includes("lib/commonlibsse-ng")
+end
 
 -- set project
 set_project("ImmersiveSpellcastingVR")
@@ -18,6 +21,27 @@ set_license("MIT")
 set_languages("c++23")
 set_warnings("allextra")
 
+-- compile-time log threshold, see src/utils/Log.h
+option("log_level")
+    set_showmenu(true)
+    set_description("Strip log calls below this level at compile time (0 = trace ... 6 = off)")
+option_end()
+
+if has_config("log_level") then
+    add_defines("ISPVR_LOG_LEVEL=" .. get_config("log_level"))
+end
+
+-- count heap allocations in hot paths, see src/core/AllocAudit.h
+option("alloc_audit")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Replace operator new to count allocations made inside ISPVR_ALLOC_AUDIT_SCOPE blocks")
+option_end()
+
+if has_config("alloc_audit") then
+    add_defines("ISPVR_ALLOC_AUDIT")
+end
+
 -- set policies
 set_policy("package.requires_lock", true)
 
@@ -84,9 +108,87 @@ rule("hkx-anim")
     end)
 
 -- targets
+
+-- Game independent logic (workers, frame tasks, haptic scheduler, dispatcher state machine, config codec, patch planner, metrics, spell table).
+-- Must not include game headers so it can be built and measured on any host.
+local core_sources = {"core/**.cpp", "utils/Clock.cpp", "utils/FrameClock.cpp", "utils/TimedWorker.cpp"}
+
+target("ispvr_core")
+    set_kind("static")
+    for _, pattern in ipairs(core_sources) do
+        add_files(path.join("src", pattern))
+        add_headerfiles(path.join("src", (pattern:gsub("%.cpp$", ".h"))))
+    end
+    add_includedirs("src", {public = true})
+    if is_plat("linux") then
+        -- std::thread, and libstdc++ runs the parallel algorithms on TBB
+        add_syslinks("pthread", "tbb", {public = true})
+    end
+target_end()
+
+-- Host tools, only built when asked for (xmake build ispvr_sim). They need nothing but ispvr_core, except for the logging
+-- benchmarks in ispvr_bench which measure the release logger on spdlog. On Windows spdlog comes with CommonLibSSE-NG.
+if not is_plat("windows") then
+    add_requires("spdlog")
+end
+
+-- Runs thousands of casts against a fake caster in virtual time and reports latency and event counts
+target("ispvr_sim")
+    set_kind("binary")
+    set_default(false)
+    add_deps("ispvr_core")
+    add_files("tools/sim/*.cpp")
+target_end()
+
+-- Microbenchmarks of the hot paths with time and allocation budgets, exits with an error if one is exceeded.
+-- Compiles its own copy of the core with allocation counting instead of linking ispvr_core.
+target("ispvr_bench")
+    set_kind("binary")
+    set_default(false)
+    for _, pattern in ipairs(core_sources) do
+        add_files(path.join("src", pattern))
+    end
+    add_files("src/utils/LogPipeline.cpp", "tools/bench/*.cpp")
+    add_includedirs("src")
+    add_defines("ISPVR_ALLOC_AUDIT")
+    add_packages("spdlog")
+    if is_plat("linux") then
+        add_syslinks("pthread", "tbb")
+    end
+target_end()
+
+-- Prints the flight recorder dumps the plugin writes when a hand gets stuck
+target("ispvr_flight_decoder")
+    set_kind("binary")
+    set_default(false)
+    add_deps("ispvr_core")
+    add_files("tools/flight/*.cpp")
+target_end()
+
+if is_plat("linux") then
+-- Samples the metrics snapshot from POSIX shared memory
+target("ispvr_metrics_reader")
+    set_kind("binary")
+    set_default(false)
+    add_deps("ispvr_core")
+    add_files("tools/metrics/Reader.cpp", "tools/metrics/SharedSegment.cpp")
+    add_syslinks("rt")
+target_end()
+
+-- Publishes made-up metrics like the plugin does, to try readers without the game
+target("ispvr_metrics_fake")
+    set_kind("binary")
+    set_default(false)
+    add_deps("ispvr_core")
+    add_files("tools/metrics/FakeProducer.cpp", "tools/metrics/SharedSegment.cpp")
+    add_syslinks("rt")
+target_end()
+end
+
+if is_plat("windows") then
 target("ISPVR")
     -- add dependencies to target
-    add_deps("commonlibsse-ng")
+    add_deps("commonlibsse-ng", "ispvr_core")
 
     -- add commonlibsse-ng plugin
     add_rules("commonlibsse-ng.plugin", {
@@ -99,7 +201,7 @@ target("ISPVR")
     })
 
     -- cpp
-    add_files("src/**.cpp")
+    add_files("src/**.cpp|" .. table.concat(core_sources, "|"))
     add_headerfiles("src/**.h")
     add_includedirs("src")
     set_pcxxheader("src/pch.h")
@@ -161,3 +263,5 @@ target("ISPVR")
             })
         end
     end)
+target_end()
+end